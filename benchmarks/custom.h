@@ -0,0 +1,95 @@
+#ifndef _CUSTOM_H_
+#define _CUSTOM_H_
+
+#include "wl.h"
+#include "txn.h"
+#include "global.h"
+#include "helper.h"
+
+class custom_query;
+class ZipfGen;
+
+// columns of every CUSTOM table.
+enum { CUSTOM_KEY, CUSTOM_CNT, CUSTOM_DATA };
+
+struct CustomTable {
+  string name;
+  uint64_t row_cnt;
+  uint32_t tuple_size;
+  // -1 for a table without a parent.
+  int parent;
+  // rows per parent row.
+  uint64_t fanout;
+  // keys [p * rows_per_part, (p + 1) * rows_per_part) are in partition p.
+  uint64_t rows_per_part;
+  bool ordered;
+  // key of each zipf rank, so that the hot keys are spread over the
+  // partitions. Empty if no access to the table is skewed.
+  std::vector<uint64_t> shuffled_keys;
+  table_t* table;
+  // one of them is set.
+  HASH_INDEX* hash_index;
+  ORDERED_INDEX* ordered_index;
+};
+
+struct CustomAccess {
+  uint32_t table_id;
+  access_t type;  // RD, WR or SCAN
+  uint32_t cnt;
+  double theta;
+  // the children of the row the txn accessed last in the parent table.
+  bool fk;
+  // NULL if the keys are uniform.
+  ZipfGen* zipf;
+};
+
+struct CustomTxn {
+  string name;
+  uint32_t weight;
+  bool read_only;
+  uint32_t access_cnt;
+  CustomAccess accesses[CUSTOM_MAX_ACCESS];
+};
+
+class custom_wl : public workload {
+ public:
+  RC init();
+  RC init_table();
+  RC init_schema(string config_file);
+  RC get_txn_man(txn_man*& txn_manager, thread_t* h_thd);
+  int key_to_part(uint32_t table_id, uint64_t key);
+
+  uint32_t table_cnt;
+  CustomTable custom_tables[CUSTOM_MAX_TABLE];
+  uint32_t txn_cnt;
+  CustomTxn txns[CUSTOM_MAX_TXN];
+  uint32_t total_weight;
+
+ private:
+  // M_ASSERTs on a malformed line.
+  void parse_config(string config_file);
+  void parse_table(vector<string>& items);
+  void parse_access(vector<string>& items);
+  int find_table(const string& name);
+
+  static void* threadInitTable(void* This);
+  void init_rows(uint32_t table_id, uint64_t begin, uint64_t end,
+                 uint64_t thd_id);
+
+  uint32_t next_tid;
+
+  uint32_t tid_lock[256];
+};
+
+class custom_txn_man : public txn_man {
+ public:
+  void init(thread_t* h_thd, workload* h_wl, uint64_t thd_id);
+  RC run_txn(base_query* query);
+
+ private:
+  custom_wl* _wl;
+  RC run_scan(uint32_t table_id, uint64_t key, uint32_t scan_len,
+              uint64_t& v);
+};
+
+#endif
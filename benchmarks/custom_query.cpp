@@ -0,0 +1,140 @@
+#include "query.h"
+#include "custom_query.h"
+#include "custom.h"
+#include "tpcc_helper.h"
+#include "mem_alloc.h"
+#include "wl.h"
+#include "zipf.h"
+
+void custom_query::init(uint64_t thd_id, workload* h_wl) {
+  requests = (custom_request*)mem_allocator.alloc(
+      sizeof(custom_request) * CUSTOM_MAX_REQ, thd_id);
+  part_to_access =
+      (uint64_t*)mem_allocator.alloc(sizeof(uint64_t) * g_part_cnt, thd_id);
+  gen(thd_id, h_wl);
+}
+
+uint32_t custom_query::trace_size() {
+  return trace_align(sizeof(txn_id)) + trace_align(sizeof(request_cnt)) +
+         trace_align(sizeof(part_num)) +
+         trace_align(sizeof(custom_request) * request_cnt) +
+         trace_align(sizeof(uint64_t) * part_num);
+}
+
+void custom_query::trace_encode(char* buf) {
+  uint32_t pos = 0;
+  trace_put(buf, pos, &txn_id, sizeof(txn_id));
+  trace_put(buf, pos, &request_cnt, sizeof(request_cnt));
+  trace_put(buf, pos, &part_num, sizeof(part_num));
+  trace_put(buf, pos, requests, sizeof(custom_request) * request_cnt);
+  trace_put(buf, pos, part_to_access, sizeof(uint64_t) * part_num);
+}
+
+void custom_query::trace_decode(char* buf) {
+  uint32_t pos = 0;
+  txn_id = *(uint32_t*)trace_get(buf, pos, sizeof(txn_id));
+  request_cnt = *(uint64_t*)trace_get(buf, pos, sizeof(request_cnt));
+  part_num = *(uint64_t*)trace_get(buf, pos, sizeof(part_num));
+  requests = (custom_request*)trace_get(
+      buf, pos, sizeof(custom_request) * request_cnt);
+  part_to_access = (uint64_t*)trace_get(buf, pos, sizeof(uint64_t) * part_num);
+}
+
+void custom_query::gen(uint64_t thd_id, workload* h_wl) {
+  auto wl = (custom_wl*)h_wl;
+
+  uint64_t x = URand(0, wl->total_weight - 1, thd_id);
+  txn_id = 0;
+  while (x >= wl->txns[txn_id].weight) x -= wl->txns[txn_id++].weight;
+  auto& txn = wl->txns[txn_id];
+
+  // the key requested last per table, for the FK accesses.
+  uint64_t last_key[CUSTOM_MAX_TABLE];
+  request_cnt = 0;
+  for (uint32_t i = 0; i < txn.access_cnt; i++) {
+    auto& access = txn.accesses[i];
+    auto& table = wl->custom_tables[access.table_id];
+    if (access.type == SCAN) {
+      auto& req = requests[request_cnt++];
+      req.table_id = access.table_id;
+      req.type = SCAN;
+      if (access.fk) {
+        req.key = last_key[table.parent] * table.fanout;
+        req.scan_len = std::min((uint64_t)access.cnt, table.fanout);
+      } else {
+        req.key = gen_key(wl, access, thd_id);
+        req.scan_len = access.cnt;
+      }
+      last_key[access.table_id] = req.key;
+      continue;
+    }
+    for (uint32_t j = 0; j < access.cnt; j++) {
+      uint64_t key;
+      if (access.fk)
+        key = gen_child_key(wl, access, last_key[table.parent], thd_id);
+      else
+        key = gen_key(wl, access, thd_id);
+      auto& req = requests[request_cnt++];
+      req.table_id = access.table_id;
+      req.type = access.type;
+      req.key = key;
+      req.scan_len = 0;
+      last_key[access.table_id] = key;
+    }
+  }
+  assert(request_cnt <= CUSTOM_MAX_REQ);
+
+  part_num = 0;
+  for (uint64_t i = 0; i < request_cnt; i++) {
+    uint64_t part_id = wl->key_to_part(requests[i].table_id, requests[i].key);
+    uint64_t j;
+    for (j = 0; j < part_num; j++)
+      if (part_to_access[j] == part_id) break;
+    if (j == part_num) part_to_access[part_num++] = part_id;
+  }
+}
+
+bool custom_query::has_key(uint32_t table_id, uint64_t key) {
+  for (uint64_t i = 0; i < request_cnt; i++)
+    if (requests[i].table_id == table_id && requests[i].type != SCAN &&
+        requests[i].key == key)
+      return true;
+  return false;
+}
+
+// draws after which a key already requested is replaced by the next free
+// one. parse_config() makes sure that there is one.
+static const uint32_t MAX_RETRY = 16;
+
+uint64_t custom_query::gen_key(custom_wl* wl, CustomAccess& access,
+                               uint64_t thd_id) {
+  auto& table = wl->custom_tables[access.table_id];
+  uint64_t key;
+  for (uint32_t i = 0;; i++) {
+    if (access.zipf != NULL) {
+      double u;
+      drand48_r(tpcc_buffer[thd_id], &u);
+      key = table.shuffled_keys[access.zipf->sample(u)];
+    } else
+      key = URand(0, table.row_cnt - 1, thd_id);
+    if (access.type == SCAN || !has_key(access.table_id, key)) return key;
+    if (i == MAX_RETRY) break;
+  }
+  while (has_key(access.table_id, key)) key = (key + 1) % table.row_cnt;
+  return key;
+}
+
+uint64_t custom_query::gen_child_key(custom_wl* wl, CustomAccess& access,
+                                     uint64_t parent_key, uint64_t thd_id) {
+  auto& table = wl->custom_tables[access.table_id];
+  uint64_t first = parent_key * table.fanout;
+  uint64_t child;
+  for (uint32_t i = 0;; i++) {
+    child = URand(0, table.fanout - 1, thd_id);
+    if (!has_key(access.table_id, first + child)) return first + child;
+    if (i == MAX_RETRY) break;
+  }
+  while (has_key(access.table_id, first + child))
+    child = (child + 1) % table.fanout;
+  return first + child;
+}
@@ -0,0 +1,40 @@
+#ifndef _CUSTOM_QUERY_H_
+#define _CUSTOM_QUERY_H_
+
+#include "global.h"
+#include "helper.h"
+#include "query.h"
+
+class workload;
+class custom_wl;
+struct CustomAccess;
+
+struct custom_request {
+  uint32_t table_id;
+  access_t type;
+  uint64_t key;
+  // rows read by a SCAN.
+  uint32_t scan_len;
+};
+
+class custom_query : public base_query {
+ public:
+  void init(uint64_t thd_id, workload* h_wl);
+  void gen(uint64_t thd_id, workload* h_wl);
+  uint32_t trace_size();
+  void trace_encode(char* buf);
+  void trace_decode(char* buf);
+
+  uint32_t txn_id;
+  uint64_t request_cnt;
+  custom_request* requests;
+
+ private:
+  // a key of the table not requested yet by the query (any key for a SCAN).
+  uint64_t gen_key(custom_wl* wl, CustomAccess& access, uint64_t thd_id);
+  uint64_t gen_child_key(custom_wl* wl, CustomAccess& access,
+                         uint64_t parent_key, uint64_t thd_id);
+  bool has_key(uint32_t table_id, uint64_t key);
+};
+
+#endif
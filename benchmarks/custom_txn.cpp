@@ -0,0 +1,90 @@
+#define CONFIG_H "silo/config/config-perf.h"
+#include "silo/rcu.h"
+#ifdef NDEBUG
+#undef NDEBUG
+#endif
+
+#include "custom.h"
+#include "custom_query.h"
+#include "query.h"
+#include "wl.h"
+#include "thread.h"
+#include "table.h"
+#include "row.h"
+#include "index_hash.h"
+#include "index_btree.h"
+#include "index_mica.h"
+#include "index_mbtree.h"
+#include "mem_alloc.h"
+#include "catalog.h"
+
+void custom_txn_man::init(thread_t* h_thd, workload* h_wl, uint64_t thd_id) {
+  txn_man::init(h_thd, h_wl, thd_id);
+  _wl = (custom_wl*)h_wl;
+}
+
+RC custom_txn_man::run_txn(base_query* query) {
+  auto m_query = (custom_query*)query;
+#if CC_ALG == MICA
+  mica_tx->begin(_wl->txns[m_query->txn_id].read_only);
+#endif
+
+  uint64_t v = 0;
+  for (uint64_t i = 0; i < m_query->request_cnt; i++) {
+    auto& req = m_query->requests[i];
+    if (req.type == SCAN) {
+      if (run_scan(req.table_id, req.key, req.scan_len, v) != RCOK)
+        return finish(Abort);
+      continue;
+    }
+
+    auto& t = _wl->custom_tables[req.table_id];
+    int part_id = _wl->key_to_part(req.table_id, req.key);
+    row_t* row;
+    if (t.hash_index != NULL)
+      row = search(t.hash_index, req.key, part_id, req.type);
+    else
+      row = search(t.ordered_index, req.key, part_id, req.type);
+    if (row == NULL) return finish(Abort);
+
+    int64_t cnt;
+    row->get_value(CUSTOM_CNT, cnt);
+    if (req.type == WR)
+      row->set_value(CUSTOM_CNT, cnt + 1);
+    else
+      v += cnt;
+  }
+  (void)v;
+  return finish(RCOK);
+}
+
+RC custom_txn_man::run_scan(uint32_t table_id, uint64_t key,
+                            uint32_t scan_len, uint64_t& v) {
+  auto& t = _wl->custom_tables[table_id];
+  auto index = t.ordered_index;
+  int part_id = _wl->key_to_part(table_id, key);
+
+  // the range stops at the last key of the partition.
+  uint64_t end_key = std::min(key + scan_len,
+                              std::min((part_id + 1) * t.rows_per_part,
+                                       t.row_cnt));
+  row_t* rows[SCAN_LEN];
+  size_t count = scan_len;
+  assert(count <= SCAN_LEN);
+  auto idx_rc = index_read_range(index, key, end_key - 1, rows, count,
+                                 part_id);
+  if (idx_rc != RCOK) return Abort;
+
+  for (size_t i = 0; i < count; i++) {
+#if CC_ALG != MICA
+    auto row = get_row(index, rows[i], part_id, RD);
+#else
+    auto row = get_row(index, rows[i], part_id, PEEK);
+#endif
+    if (row == NULL) return Abort;
+    int64_t cnt;
+    row->get_value(CUSTOM_CNT, cnt);
+    v += cnt;
+  }
+  return RCOK;
+}
@@ -0,0 +1,338 @@
+#include "global.h"
+#include "helper.h"
+#include "custom.h"
+#include "wl.h"
+#include "thread.h"
+#include "table.h"
+#include "index_hash.h"
+#include "index_btree.h"
+#include "index_mica.h"
+#include "index_mbtree.h"
+#include "index_mica_mbtree.h"
+#include "tpcc_helper.h"
+#include "row.h"
+#include "query.h"
+#include "txn.h"
+#include "mem_alloc.h"
+#include "catalog.h"
+#include "zipf.h"
+#include <random>
+
+RC custom_wl::init() {
+  workload::init();
+  next_tid = 0;
+  init_schema(g_params["custom_config"]);
+  init_table();
+  return RCOK;
+}
+
+static void split(string line, vector<string>& items) {
+  items.clear();
+  while (line.length() != 0) {
+    size_t pos = line.find(",");
+    if (pos == string::npos) pos = line.length();
+    string token = line.substr(0, pos);
+    size_t begin = token.find_first_not_of(" \t\r");
+    size_t end = token.find_last_not_of(" \t\r");
+    items.push_back(begin == string::npos ? ""
+                                          : token.substr(begin, end - begin + 1));
+    line.erase(0, pos + 1);
+  }
+}
+
+int custom_wl::find_table(const string& name) {
+  for (uint32_t i = 0; i < table_cnt; i++)
+    if (custom_tables[i].name == name) return i;
+  return -1;
+}
+
+void custom_wl::parse_table(vector<string>& items) {
+  M_ASSERT(items.size() == 5 || items.size() == 6,
+           "TABLE,<name>,<row_cnt>,<tuple_size>,<HASH|ORDERED>[,<parent>]\n");
+  M_ASSERT(table_cnt < CUSTOM_MAX_TABLE, "too many tables\n");
+  M_ASSERT(find_table(items[1]) == -1, "table %s declared twice\n",
+           items[1].c_str());
+  auto& table = custom_tables[table_cnt];
+  table.name = items[1];
+  table.row_cnt = stoull(items[2]);
+  table.tuple_size = stoul(items[3]);
+  M_ASSERT(table.row_cnt > 0, "%s: no rows\n", table.name.c_str());
+  M_ASSERT(table.tuple_size >= 16 && table.tuple_size <= MAX_TUPLE_SIZE,
+           "%s: tuple_size must be in [16, MAX_TUPLE_SIZE]\n",
+           table.name.c_str());
+  M_ASSERT(items[4] == "HASH" || items[4] == "ORDERED",
+           "%s: unknown index type %s\n", table.name.c_str(),
+           items[4].c_str());
+  table.ordered = items[4] == "ORDERED";
+
+  if (items.size() == 6) {
+    table.parent = find_table(items[5]);
+    M_ASSERT(table.parent != -1, "%s: parent %s is not declared before\n",
+             table.name.c_str(), items[5].c_str());
+    auto& parent = custom_tables[table.parent];
+    M_ASSERT(table.row_cnt % parent.row_cnt == 0,
+             "%s: row_cnt is not a multiple of the row_cnt of %s\n",
+             table.name.c_str(), parent.name.c_str());
+    table.fanout = table.row_cnt / parent.row_cnt;
+    table.rows_per_part = parent.rows_per_part * table.fanout;
+  } else {
+    table.parent = -1;
+    table.fanout = 0;
+    table.rows_per_part = (table.row_cnt + g_part_cnt - 1) / g_part_cnt;
+  }
+  table_cnt++;
+}
+
+void custom_wl::parse_access(vector<string>& items) {
+  M_ASSERT(items.size() == 5,
+           "ACCESS,<table>,<RD|WR|SCAN>,<count>,<theta|FK>\n");
+  M_ASSERT(txn_cnt > 0, "ACCESS before the first TXN\n");
+  auto& txn = txns[txn_cnt - 1];
+  M_ASSERT(txn.access_cnt < CUSTOM_MAX_ACCESS, "%s: too many accesses\n",
+           txn.name.c_str());
+  auto& access = txn.accesses[txn.access_cnt];
+  int table_id = find_table(items[1]);
+  M_ASSERT(table_id != -1, "%s: unknown table %s\n", txn.name.c_str(),
+           items[1].c_str());
+  access.table_id = table_id;
+  auto& table = custom_tables[table_id];
+  if (items[2] == "RD")
+    access.type = RD;
+  else if (items[2] == "WR")
+    access.type = WR;
+  else if (items[2] == "SCAN")
+    access.type = SCAN;
+  else
+    M_ASSERT(false, "%s: unknown access type %s\n", txn.name.c_str(),
+             items[2].c_str());
+  access.cnt = stoul(items[3]);
+  M_ASSERT(access.cnt > 0, "%s: empty access\n", txn.name.c_str());
+  if (access.type == SCAN) {
+    M_ASSERT(table.ordered && access.cnt <= SCAN_LEN,
+             "%s: SCAN needs an ORDERED table and at most SCAN_LEN rows\n",
+             txn.name.c_str());
+  } else
+    txn.read_only &= access.type == RD;
+
+  access.fk = items[4] == "FK";
+  access.theta = access.fk ? 0 : stod(items[4]);
+  access.zipf = NULL;
+  if (access.fk) {
+    M_ASSERT(table.parent != -1, "%s: %s has no parent for FK\n",
+             txn.name.c_str(), table.name.c_str());
+    bool found = false;
+    for (uint32_t i = 0; i < txn.access_cnt; i++)
+      found |= txn.accesses[i].table_id == (uint32_t)table.parent;
+    M_ASSERT(found, "%s: FK access to %s before any access to %s\n",
+             txn.name.c_str(), table.name.c_str(),
+             custom_tables[table.parent].name.c_str());
+  } else if (access.theta != 0) {
+    access.zipf = (ZipfGen*)mem_allocator.alloc(sizeof(ZipfGen), -1);
+    access.zipf->init(table.row_cnt, access.theta);
+    if (table.shuffled_keys.empty()) {
+      // fixed per table, so that a recorded trace replays the same keys.
+      std::mt19937 g(table_id + 1);
+      table.shuffled_keys.reserve(table.row_cnt);
+      for (uint64_t i = 0; i < table.row_cnt; i++)
+        table.shuffled_keys.push_back(i);
+      std::shuffle(table.shuffled_keys.begin(), table.shuffled_keys.end(), g);
+    }
+  }
+  txn.access_cnt++;
+}
+
+void custom_wl::parse_config(string config_file) {
+  ifstream fin(config_file);
+  M_ASSERT(fin.is_open(), "cannot open %s\n", config_file.c_str());
+  table_cnt = 0;
+  txn_cnt = 0;
+  total_weight = 0;
+  string line;
+  vector<string> items;
+  while (getline(fin, line)) {
+    size_t comment = line.find("#");
+    if (comment != string::npos) line.erase(comment);
+    if (line.find_first_not_of(" \t\r") == string::npos) continue;
+    split(line, items);
+    if (items[0] == "TABLE")
+      parse_table(items);
+    else if (items[0] == "TXN") {
+      M_ASSERT(items.size() == 3, "TXN,<name>,<weight>\n");
+      M_ASSERT(txn_cnt < CUSTOM_MAX_TXN, "too many txns\n");
+      auto& txn = txns[txn_cnt++];
+      txn.name = items[1];
+      txn.weight = stoul(items[2]);
+      txn.read_only = true;
+      txn.access_cnt = 0;
+      total_weight += txn.weight;
+    } else if (items[0] == "ACCESS")
+      parse_access(items);
+    else
+      M_ASSERT(false, "unknown line: %s\n", line.c_str());
+  }
+  fin.close();
+  M_ASSERT(table_cnt > 0 && total_weight > 0, "no tables or txns in %s\n",
+           config_file.c_str());
+
+  // the distinct keys a query picks per table must exist (among the
+  // children of one parent row if the table has FK accesses), and a
+  // scanned table cannot be written by the same txn (no lock upgrades).
+  for (uint32_t i = 0; i < txn_cnt; i++) {
+    auto& txn = txns[i];
+    uint64_t req_cnt = 0;
+    for (uint32_t t = 0; t < table_cnt; t++) {
+      uint64_t key_cnt = 0;
+      uint64_t child_cnt = 0;
+      bool scan = false;
+      bool write = false;
+      for (uint32_t j = 0; j < txn.access_cnt; j++) {
+        auto& access = txn.accesses[j];
+        if (access.table_id != t) continue;
+        scan |= access.type == SCAN;
+        write |= access.type == WR;
+        if (access.type == SCAN) continue;
+        key_cnt += access.cnt;
+        if (access.fk) child_cnt += access.cnt;
+      }
+      req_cnt += key_cnt;
+      M_ASSERT(key_cnt <= custom_tables[t].row_cnt &&
+                   (child_cnt == 0 || key_cnt <= custom_tables[t].fanout),
+               "%s: more rows of %s than it has\n", txn.name.c_str(),
+               custom_tables[t].name.c_str());
+      M_ASSERT(!(scan && write), "%s: %s is scanned and written\n",
+               txn.name.c_str(), custom_tables[t].name.c_str());
+    }
+    for (uint32_t j = 0; j < txn.access_cnt; j++)
+      if (txn.accesses[j].type == SCAN) req_cnt++;
+    M_ASSERT(req_cnt <= CUSTOM_MAX_REQ, "%s: more than CUSTOM_MAX_REQ rows\n",
+             txn.name.c_str());
+  }
+}
+
+RC custom_wl::init_schema(string config_file) {
+  parse_config(config_file);
+
+#if CC_ALG == MICA
+  set_mica_active(true);
+#endif
+  int part_cnt = (CENTRAL_INDEX) ? 1 : g_part_cnt;
+  for (uint32_t i = 0; i < table_cnt; i++) {
+    auto& t = custom_tables[i];
+    uint32_t data_size = t.tuple_size - 16;
+    Catalog* schema = (Catalog*)mem_allocator.alloc(sizeof(Catalog), -1);
+    schema->init(t.name.c_str(), data_size > 0 ? 3 : 2);
+    schema->add_col((char*)"KEY", 8, (char*)"int64_t", 0);
+    schema->add_col((char*)"CNT", 8, (char*)"int64_t", 0);
+    if (data_size > 0)
+      schema->add_col((char*)"DATA", data_size, (char*)"string", 0);
+    schema->finalize();
+    t.table = add_table(t.name, schema, part_cnt);
+
+    // add_index() picks the index type by the prefix.
+    string iname = (t.ordered ? "ORDERED_" : "HASH_") + t.name + "_IDX";
+    add_index(iname, t.table, part_cnt, t.row_cnt);
+    t.ordered_index = t.ordered ? ordered_indexes[iname] : NULL;
+    t.hash_index = t.ordered ? NULL : hash_indexes[iname];
+  }
+#if CC_ALG == MICA
+  set_mica_active(false);
+#endif
+  return RCOK;
+}
+
+RC custom_wl::init_table() {
+  assert(g_init_parallelism <= g_thread_cnt);
+
+  // the query generators of all the worker threads use it as well.
+  tpcc_buffer = new drand48_data*[g_thread_cnt];
+
+  for (uint32_t i = 0; i < g_thread_cnt; i++) {
+    tpcc_buffer[i] =
+        (drand48_data*)mem_allocator.alloc(sizeof(drand48_data), -1);
+    srand48_r(i + 1, tpcc_buffer[i]);
+  }
+
+  pthread_t* p_thds = new pthread_t[g_init_parallelism - 1];
+  for (uint32_t i = 0; i < g_init_parallelism; i++) tid_lock[i] = 0;
+  for (uint32_t i = 0; i < g_init_parallelism - 1; i++) {
+    pthread_create(&p_thds[i], NULL, threadInitTable, this);
+  }
+  threadInitTable(this);
+  for (uint32_t i = 0; i < g_init_parallelism - 1; i++)
+    pthread_join(p_thds[i], NULL);
+
+  printf("CUSTOM Data Initialization Complete!\n");
+  return RCOK;
+}
+
+int custom_wl::key_to_part(uint32_t table_id, uint64_t key) {
+  return key / custom_tables[table_id].rows_per_part;
+}
+
+void custom_wl::init_rows(uint32_t table_id, uint64_t begin, uint64_t end,
+                          uint64_t thd_id) {
+  auto& t = custom_tables[table_id];
+  char data[MAX_TUPLE_SIZE];
+  for (uint32_t i = 0; i < sizeof(data); i++) data[i] = 'a' + i % 26;
+
+  for (uint64_t key = begin; key < end; key++) {
+    int part_id = key_to_part(table_id, key);
+    row_t* new_row = NULL;
+#if CC_ALG == MICA
+    row_t row_container;
+    new_row = &row_container;
+#endif
+    uint64_t row_id;
+    auto rc = t.table->get_new_row(new_row, part_id, row_id);
+    assert(rc == RCOK);
+    new_row->set_primary_key(key);
+    new_row->set_value(CUSTOM_KEY, (int64_t)key);
+    new_row->set_value(CUSTOM_CNT, (int64_t)0);
+    if (t.tuple_size > 16) new_row->set_value(CUSTOM_DATA, data);
+
+    if (t.hash_index != NULL)
+      index_insert(t.hash_index, key, new_row, part_id);
+    else
+      index_insert(t.ordered_index, key, new_row, part_id);
+  }
+  (void)thd_id;
+}
+
+RC custom_wl::get_txn_man(txn_man*& txn_manager, thread_t* h_thd) {
+  txn_manager = (custom_txn_man*)mem_allocator.alloc(sizeof(custom_txn_man),
+                                                     h_thd->get_thd_id());
+  new (txn_manager) custom_txn_man();
+  txn_manager->init(h_thd, this, h_thd->get_thd_id());
+  return RCOK;
+}
+
+void* custom_wl::threadInitTable(void* This) {
+  custom_wl* wl = (custom_wl*)This;
+  int tid = ATOM_FETCH_ADD(wl->next_tid, 1);
+  assert(tid < (int)g_thread_cnt);
+
+#if CC_ALG == MICA
+  ::mica::util::lcore.pin_thread(tid);
+  while (__sync_lock_test_and_set(&wl->tid_lock[tid], 1) == 1) usleep(100);
+  wl->mica_db->activate(static_cast<uint16_t>(tid));
+#else
+  set_affinity(tid);
+#endif
+
+  mem_allocator.register_thread(tid);
+
+  for (uint32_t table_id = 0; table_id < wl->table_cnt; table_id++) {
+    uint64_t row_cnt = wl->custom_tables[table_id].row_cnt;
+    uint64_t slice_size =
+        (row_cnt + g_init_parallelism - 1) / g_init_parallelism;
+    uint64_t begin = std::min(slice_size * tid, row_cnt);
+    uint64_t end = std::min(begin + slice_size, row_cnt);
+    wl->init_rows(table_id, begin, end, tid);
+  }
+
+#if CC_ALG == MICA
+  wl->mica_db->deactivate(static_cast<uint16_t>(tid));
+  __sync_lock_release(&wl->tid_lock[tid]);
+#endif
+  return NULL;
+}
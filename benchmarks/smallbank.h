@@ -0,0 +1,59 @@
+#ifndef _SMALLBANK_H_
+#define _SMALLBANK_H_
+
+#include "wl.h"
+#include "txn.h"
+#include "global.h"
+#include "helper.h"
+
+class smallbank_query;
+
+class smallbank_wl : public workload {
+ public:
+  RC init();
+  RC init_table();
+  RC init_schema(string schema_file);
+  RC get_txn_man(txn_man*& txn_manager, thread_t* h_thd);
+  int key_to_part(uint64_t key);
+
+  table_t* t_accounts;
+  table_t* t_savings;
+  table_t* t_checking;
+
+  HASH_INDEX* i_accounts;
+  HASH_INDEX* i_savings;
+  HASH_INDEX* i_checking;
+
+ private:
+  static void* threadInitTable(void* This);
+
+  void gen_account(uint64_t custid, uint64_t thd_id);
+
+  uint32_t next_tid;
+
+  uint32_t tid_lock[256];
+};
+
+class smallbank_txn_man : public txn_man {
+ public:
+  void init(thread_t* h_thd, workload* h_wl, uint64_t thd_id);
+  RC run_txn(base_query* query);
+
+ private:
+  smallbank_wl* _wl;
+  RC run_amalgamate(smallbank_query* query);
+  RC run_balance(smallbank_query* query);
+  RC run_deposit_checking(smallbank_query* query);
+  RC run_send_payment(smallbank_query* query);
+  RC run_transact_savings(smallbank_query* query);
+  RC run_write_check(smallbank_query* query);
+
+  int key_to_part(uint64_t key) { return _wl->key_to_part(key); }
+
+  // the customer must exist; NULL means the CC aborted.
+  bool check_account(uint64_t custid);
+  row_t* get_savings(uint64_t custid, access_t type);
+  row_t* get_checking(uint64_t custid, access_t type);
+};
+
+#endif
@@ -0,0 +1,22 @@
+enum class AccountsConst {
+  custid,
+  name,
+};
+
+enum class SavingsConst {
+  custid,
+  bal,
+};
+
+enum class CheckingConst {
+  custid,
+  bal,
+};
+
+// Transaction amounts used by the H-Store / OLTP-Bench SmallBank.
+#define SB_AMOUNT_DEPOSIT_CHECKING 1.3
+#define SB_AMOUNT_SEND_PAYMENT 5.0
+#define SB_AMOUNT_TRANSACT_SAVINGS 20.20
+#define SB_AMOUNT_WRITE_CHECK 5.0
+
+#define SB_NAME_SIZE 64
@@ -0,0 +1,24 @@
+#include "smallbank_helper.h"
+
+uint64_t accountKey(uint64_t custid) { return custid; }
+
+uint64_t sb_getCustomerId(uint64_t thd_id) {
+  uint64_t hotspot_size = std::min((uint64_t)SB_HOTSPOT_SIZE, g_sb_num_accounts);
+  if (hotspot_size == g_sb_num_accounts ||
+      (hotspot_size != 0 && URand(1, 100, thd_id) <= SB_HOTSPOT_PERC))
+    return URand(0, hotspot_size - 1, thd_id);
+  return URand(hotspot_size, g_sb_num_accounts - 1, thd_id);
+}
+
+uint64_t sb_getOtherCustomerId(uint64_t custid, uint64_t thd_id) {
+  assert(g_sb_num_accounts > 1);
+  uint64_t other;
+  do {
+    other = sb_getCustomerId(thd_id);
+  } while (other == custid);
+  return other;
+}
+
+double sb_getBalance(uint64_t thd_id) {
+  return (double)URand(SB_MIN_BALANCE, SB_MAX_BALANCE, thd_id);
+}
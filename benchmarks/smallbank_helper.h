@@ -0,0 +1,16 @@
+#pragma once
+#include "global.h"
+#include "helper.h"
+
+// borrow some functions from TPCC
+#include "tpcc_helper.h"
+
+// ACCOUNTS_IDX, SAVINGS_IDX, CHECKING_IDX
+uint64_t accountKey(uint64_t custid);
+
+// A customer in the hotspot with SB_HOTSPOT_PERC % probability.
+uint64_t sb_getCustomerId(uint64_t thd_id);
+// A customer other than custid.
+uint64_t sb_getOtherCustomerId(uint64_t custid, uint64_t thd_id);
+
+double sb_getBalance(uint64_t thd_id);
@@ -0,0 +1,90 @@
+#include "query.h"
+#include "smallbank_query.h"
+#include "smallbank.h"
+#include "smallbank_helper.h"
+#include "smallbank_const.h"
+#include "mem_alloc.h"
+#include "wl.h"
+#include "table.h"
+
+void smallbank_query::init(uint64_t thd_id, workload* h_wl) {
+  int64_t x = (int64_t)URand(0, 99, thd_id);
+  if ((x -= SB_FREQUENCY_AMALGAMATE) < 0)
+    gen_amalgamate(thd_id);
+  else if ((x -= SB_FREQUENCY_BALANCE) < 0)
+    gen_balance(thd_id);
+  else if ((x -= SB_FREQUENCY_DEPOSIT_CHECKING) < 0)
+    gen_deposit_checking(thd_id);
+  else if ((x -= SB_FREQUENCY_SEND_PAYMENT) < 0)
+    gen_send_payment(thd_id);
+  else if ((x -= SB_FREQUENCY_TRANSACT_SAVINGS) < 0)
+    gen_transact_savings(thd_id);
+  else if ((x -= SB_FREQUENCY_WRITE_CHECK) < 0)
+    gen_write_check(thd_id);
+  else
+    assert(false);
+}
+
+uint32_t smallbank_query::trace_size() {
+  return trace_align(sizeof(type)) + trace_align(sizeof(args));
+}
+
+void smallbank_query::trace_encode(char* buf) {
+  uint32_t pos = 0;
+  trace_put(buf, pos, &type, sizeof(type));
+  trace_put(buf, pos, &args, sizeof(args));
+}
+
+void smallbank_query::trace_decode(char* buf) {
+  uint32_t pos = 0;
+  memcpy(&type, trace_get(buf, pos, sizeof(type)), sizeof(type));
+  memcpy(&args, trace_get(buf, pos, sizeof(args)), sizeof(args));
+}
+
+void smallbank_query::gen_amalgamate(uint64_t thd_id) {
+  type = SmallBankTxnType::Amalgamate;
+  auto& arg = args.amalgamate;
+
+  arg.custid_0 = sb_getCustomerId(thd_id);
+  arg.custid_1 = sb_getOtherCustomerId(arg.custid_0, thd_id);
+}
+
+void smallbank_query::gen_balance(uint64_t thd_id) {
+  type = SmallBankTxnType::Balance;
+  auto& arg = args.balance;
+
+  arg.custid = sb_getCustomerId(thd_id);
+}
+
+void smallbank_query::gen_deposit_checking(uint64_t thd_id) {
+  type = SmallBankTxnType::DepositChecking;
+  auto& arg = args.deposit_checking;
+
+  arg.custid = sb_getCustomerId(thd_id);
+  arg.amount = SB_AMOUNT_DEPOSIT_CHECKING;
+}
+
+void smallbank_query::gen_send_payment(uint64_t thd_id) {
+  type = SmallBankTxnType::SendPayment;
+  auto& arg = args.send_payment;
+
+  arg.custid_0 = sb_getCustomerId(thd_id);
+  arg.custid_1 = sb_getOtherCustomerId(arg.custid_0, thd_id);
+  arg.amount = SB_AMOUNT_SEND_PAYMENT;
+}
+
+void smallbank_query::gen_transact_savings(uint64_t thd_id) {
+  type = SmallBankTxnType::TransactSavings;
+  auto& arg = args.transact_savings;
+
+  arg.custid = sb_getCustomerId(thd_id);
+  arg.amount = SB_AMOUNT_TRANSACT_SAVINGS;
+}
+
+void smallbank_query::gen_write_check(uint64_t thd_id) {
+  type = SmallBankTxnType::WriteCheck;
+  auto& arg = args.write_check;
+
+  arg.custid = sb_getCustomerId(thd_id);
+  arg.amount = SB_AMOUNT_WRITE_CHECK;
+}
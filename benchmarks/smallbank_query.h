@@ -0,0 +1,71 @@
+#ifndef _SMALLBANK_QUERY_H_
+#define _SMALLBANK_QUERY_H_
+
+#include "global.h"
+#include "helper.h"
+#include "query.h"
+
+class workload;
+
+struct smallbank_query_amalgamate {
+  uint64_t custid_0;
+  uint64_t custid_1;
+};
+struct smallbank_query_balance {
+  uint64_t custid;
+};
+struct smallbank_query_deposit_checking {
+  uint64_t custid;
+  double amount;
+};
+struct smallbank_query_send_payment {
+  uint64_t custid_0;
+  uint64_t custid_1;
+  double amount;
+};
+struct smallbank_query_transact_savings {
+  uint64_t custid;
+  double amount;
+};
+struct smallbank_query_write_check {
+  uint64_t custid;
+  double amount;
+};
+
+enum class SmallBankTxnType {
+  Amalgamate,
+  Balance,
+  DepositChecking,
+  SendPayment,
+  TransactSavings,
+  WriteCheck,
+};
+
+class smallbank_query : public base_query {
+ public:
+  void init(uint64_t thd_id, workload* h_wl);
+  void gen(uint64_t thd_id, workload* h_wl) { init(thd_id, h_wl); }
+  uint32_t trace_size();
+  void trace_encode(char* buf);
+  void trace_decode(char* buf);
+
+  SmallBankTxnType type;
+  union {
+    smallbank_query_amalgamate amalgamate;
+    smallbank_query_balance balance;
+    smallbank_query_deposit_checking deposit_checking;
+    smallbank_query_send_payment send_payment;
+    smallbank_query_transact_savings transact_savings;
+    smallbank_query_write_check write_check;
+  } args;
+
+ private:
+  void gen_amalgamate(uint64_t thd_id);
+  void gen_balance(uint64_t thd_id);
+  void gen_deposit_checking(uint64_t thd_id);
+  void gen_send_payment(uint64_t thd_id);
+  void gen_transact_savings(uint64_t thd_id);
+  void gen_write_check(uint64_t thd_id);
+};
+
+#endif
@@ -0,0 +1,218 @@
+#define CONFIG_H "silo/config/config-perf.h"
+#include "silo/rcu.h"
+#ifdef NDEBUG
+#undef NDEBUG
+#endif
+
+#include "smallbank.h"
+#include "smallbank_query.h"
+#include "smallbank_helper.h"
+#include "query.h"
+#include "wl.h"
+#include "thread.h"
+#include "table.h"
+#include "row.h"
+#include "index_hash.h"
+#include "index_btree.h"
+#include "index_mica.h"
+#include "index_mbtree.h"
+#include "smallbank_const.h"
+#include "mem_alloc.h"
+#include "catalog.h"
+
+void smallbank_txn_man::init(thread_t* h_thd, workload* h_wl,
+                             uint64_t thd_id) {
+  txn_man::init(h_thd, h_wl, thd_id);
+  _wl = (smallbank_wl*)h_wl;
+}
+
+RC smallbank_txn_man::run_txn(base_query* query) {
+  RC rc;
+
+  auto m_query = (smallbank_query*)query;
+  switch (m_query->type) {
+    case SmallBankTxnType::Amalgamate:
+#if CC_ALG == MICA
+      mica_tx->begin(false);
+#endif
+      rc = run_amalgamate(m_query);
+      break;
+    case SmallBankTxnType::Balance:
+#if CC_ALG == MICA
+      mica_tx->begin(true);
+#endif
+      rc = run_balance(m_query);
+      break;
+    case SmallBankTxnType::DepositChecking:
+#if CC_ALG == MICA
+      mica_tx->begin(false);
+#endif
+      rc = run_deposit_checking(m_query);
+      break;
+    case SmallBankTxnType::SendPayment:
+#if CC_ALG == MICA
+      mica_tx->begin(false);
+#endif
+      rc = run_send_payment(m_query);
+      break;
+    case SmallBankTxnType::TransactSavings:
+#if CC_ALG == MICA
+      mica_tx->begin(false);
+#endif
+      rc = run_transact_savings(m_query);
+      break;
+    case SmallBankTxnType::WriteCheck:
+#if CC_ALG == MICA
+      mica_tx->begin(false);
+#endif
+      rc = run_write_check(m_query);
+      break;
+    default:
+      rc = ERROR;
+      assert(false);
+  }
+
+  return rc;
+}
+
+bool smallbank_txn_man::check_account(uint64_t custid) {
+  auto index = _wl->i_accounts;
+  auto key = accountKey(custid);
+  auto part_id = key_to_part(custid);
+  return search(index, key, part_id, RD) != NULL;
+}
+
+row_t* smallbank_txn_man::get_savings(uint64_t custid, access_t type) {
+  auto index = _wl->i_savings;
+  auto key = accountKey(custid);
+  auto part_id = key_to_part(custid);
+  return search(index, key, part_id, type);
+}
+
+row_t* smallbank_txn_man::get_checking(uint64_t custid, access_t type) {
+  auto index = _wl->i_checking;
+  auto key = accountKey(custid);
+  auto part_id = key_to_part(custid);
+  return search(index, key, part_id, type);
+}
+
+RC smallbank_txn_man::run_amalgamate(smallbank_query* query) {
+  auto& arg = query->args.amalgamate;
+
+  if (!check_account(arg.custid_0) || !check_account(arg.custid_1))
+    return finish(Abort);
+
+  // DBx1000 cannot handle upgrades, so we have to request WR.
+  auto savings_0 = get_savings(arg.custid_0, WR);
+  if (savings_0 == NULL) return finish(Abort);
+  auto checking_0 = get_checking(arg.custid_0, WR);
+  if (checking_0 == NULL) return finish(Abort);
+  auto checking_1 = get_checking(arg.custid_1, WR);
+  if (checking_1 == NULL) return finish(Abort);
+
+  double savings_bal_0, checking_bal_0, checking_bal_1;
+  savings_0->get_value((int)SavingsConst::bal, savings_bal_0);
+  checking_0->get_value((int)CheckingConst::bal, checking_bal_0);
+  checking_1->get_value((int)CheckingConst::bal, checking_bal_1);
+
+  double total = savings_bal_0 + checking_bal_0;
+  savings_0->set_value((int)SavingsConst::bal, 0.);
+  checking_0->set_value((int)CheckingConst::bal, 0.);
+  checking_1->set_value((int)CheckingConst::bal, checking_bal_1 + total);
+  return finish(RCOK);
+}
+
+RC smallbank_txn_man::run_balance(smallbank_query* query) {
+  auto& arg = query->args.balance;
+
+  if (!check_account(arg.custid)) return finish(Abort);
+
+  auto savings = get_savings(arg.custid, RD);
+  if (savings == NULL) return finish(Abort);
+  auto checking = get_checking(arg.custid, RD);
+  if (checking == NULL) return finish(Abort);
+
+  double savings_bal, checking_bal;
+  savings->get_value((int)SavingsConst::bal, savings_bal);
+  checking->get_value((int)CheckingConst::bal, checking_bal);
+  volatile double total = savings_bal + checking_bal;
+  (void)total;
+  return finish(RCOK);
+}
+
+RC smallbank_txn_man::run_deposit_checking(smallbank_query* query) {
+  auto& arg = query->args.deposit_checking;
+
+  if (!check_account(arg.custid)) return finish(Abort);
+
+  auto checking = get_checking(arg.custid, WR);
+  if (checking == NULL) return finish(Abort);
+
+  double checking_bal;
+  checking->get_value((int)CheckingConst::bal, checking_bal);
+  checking->set_value((int)CheckingConst::bal, checking_bal + arg.amount);
+  return finish(RCOK);
+}
+
+RC smallbank_txn_man::run_send_payment(smallbank_query* query) {
+  auto& arg = query->args.send_payment;
+
+  if (!check_account(arg.custid_0) || !check_account(arg.custid_1))
+    return finish(Abort);
+
+  auto checking_0 = get_checking(arg.custid_0, WR);
+  if (checking_0 == NULL) return finish(Abort);
+  auto checking_1 = get_checking(arg.custid_1, WR);
+  if (checking_1 == NULL) return finish(Abort);
+
+  double checking_bal_0, checking_bal_1;
+  checking_0->get_value((int)CheckingConst::bal, checking_bal_0);
+  if (checking_bal_0 < arg.amount) {
+    // Insufficient funds -- accept it without aborting TX.
+    return finish(RCOK);
+  }
+  checking_1->get_value((int)CheckingConst::bal, checking_bal_1);
+
+  checking_0->set_value((int)CheckingConst::bal, checking_bal_0 - arg.amount);
+  checking_1->set_value((int)CheckingConst::bal, checking_bal_1 + arg.amount);
+  return finish(RCOK);
+}
+
+RC smallbank_txn_man::run_transact_savings(smallbank_query* query) {
+  auto& arg = query->args.transact_savings;
+
+  if (!check_account(arg.custid)) return finish(Abort);
+
+  auto savings = get_savings(arg.custid, WR);
+  if (savings == NULL) return finish(Abort);
+
+  double savings_bal;
+  savings->get_value((int)SavingsConst::bal, savings_bal);
+  if (savings_bal + arg.amount < 0.) {
+    // Negative balance -- accept it without aborting TX.
+    return finish(RCOK);
+  }
+  savings->set_value((int)SavingsConst::bal, savings_bal + arg.amount);
+  return finish(RCOK);
+}
+
+RC smallbank_txn_man::run_write_check(smallbank_query* query) {
+  auto& arg = query->args.write_check;
+
+  if (!check_account(arg.custid)) return finish(Abort);
+
+  auto savings = get_savings(arg.custid, RD);
+  if (savings == NULL) return finish(Abort);
+  auto checking = get_checking(arg.custid, WR);
+  if (checking == NULL) return finish(Abort);
+
+  double savings_bal, checking_bal;
+  savings->get_value((int)SavingsConst::bal, savings_bal);
+  checking->get_value((int)CheckingConst::bal, checking_bal);
+
+  // Overdraft penalty of 1.
+  double amount = arg.amount;
+  if (savings_bal + checking_bal < amount) amount += 1.;
+  checking->set_value((int)CheckingConst::bal, checking_bal - amount);
+  return finish(RCOK);
+}
@@ -0,0 +1,167 @@
+#include "global.h"
+#include "helper.h"
+#include "smallbank.h"
+#include "wl.h"
+#include "thread.h"
+#include "table.h"
+#include "index_hash.h"
+#include "index_btree.h"
+#include "index_mica.h"
+#include "index_mbtree.h"
+#include "smallbank_helper.h"
+#include "row.h"
+#include "query.h"
+#include "txn.h"
+#include "mem_alloc.h"
+#include "smallbank_const.h"
+
+RC smallbank_wl::init() {
+  workload::init();
+  next_tid = 0;
+  char* cpath = getenv("GRAPHITE_HOME");
+  string path;
+  if (cpath == NULL)
+    path = "./benchmarks/SMALLBANK_schema.txt";
+  else {
+    path = string(cpath);
+    path += "/tests/apps/dbms/SMALLBANK_schema.txt";
+  }
+  init_schema(path);
+
+  init_table();
+  return RCOK;
+}
+
+RC smallbank_wl::init_schema(string schema_file) {
+  workload::init_schema(schema_file);
+
+  t_accounts = tables["ACCOUNTS"];
+  t_savings = tables["SAVINGS"];
+  t_checking = tables["CHECKING"];
+
+  i_accounts = hash_indexes["HASH_ACCOUNTS_IDX"];
+  i_savings = hash_indexes["HASH_SAVINGS_IDX"];
+  i_checking = hash_indexes["HASH_CHECKING_IDX"];
+
+  return RCOK;
+}
+
+RC smallbank_wl::init_table() {
+  assert(g_init_parallelism <= g_thread_cnt);
+
+  // the query generators of all the worker threads use it as well.
+  tpcc_buffer = new drand48_data*[g_thread_cnt];
+
+  for (uint32_t i = 0; i < g_thread_cnt; i++) {
+    tpcc_buffer[i] =
+        (drand48_data*)mem_allocator.alloc(sizeof(drand48_data), -1);
+    srand48_r(i + 1, tpcc_buffer[i]);
+  }
+
+  pthread_t* p_thds = new pthread_t[g_init_parallelism - 1];
+  for (uint32_t i = 0; i < g_init_parallelism; i++) tid_lock[i] = 0;
+  for (uint32_t i = 0; i < g_init_parallelism - 1; i++) {
+    pthread_create(&p_thds[i], NULL, threadInitTable, this);
+  }
+  threadInitTable(this);
+  for (uint32_t i = 0; i < g_init_parallelism - 1; i++)
+    pthread_join(p_thds[i], NULL);
+
+  printf("SmallBank Data Initialization Complete!\n");
+  return RCOK;
+}
+
+int smallbank_wl::key_to_part(uint64_t key) { return key % g_part_cnt; }
+
+void smallbank_wl::gen_account(uint64_t custid, uint64_t thd_id) {
+  int part_id = key_to_part(custid);
+  uint64_t idx_key = accountKey(custid);
+
+  {
+    row_t* new_row = NULL;
+#if CC_ALG == MICA
+    row_t row_container;
+    new_row = &row_container;
+#endif
+    uint64_t row_id;
+    auto rc = t_accounts->get_new_row(new_row, part_id, row_id);
+    assert(rc == RCOK);
+
+    new_row->set_value((int)AccountsConst::custid, (int64_t)custid);
+    char name[SB_NAME_SIZE];
+    memset(name, 0, sizeof(name));
+    snprintf(name, sizeof(name), "%lu", custid);
+    new_row->set_value((int)AccountsConst::name, name);
+
+    index_insert(i_accounts, idx_key, new_row, part_id);
+  }
+  {
+    row_t* new_row = NULL;
+#if CC_ALG == MICA
+    row_t row_container;
+    new_row = &row_container;
+#endif
+    uint64_t row_id;
+    auto rc = t_savings->get_new_row(new_row, part_id, row_id);
+    assert(rc == RCOK);
+
+    new_row->set_value((int)SavingsConst::custid, (int64_t)custid);
+    new_row->set_value((int)SavingsConst::bal, sb_getBalance(thd_id));
+
+    index_insert(i_savings, idx_key, new_row, part_id);
+  }
+  {
+    row_t* new_row = NULL;
+#if CC_ALG == MICA
+    row_t row_container;
+    new_row = &row_container;
+#endif
+    uint64_t row_id;
+    auto rc = t_checking->get_new_row(new_row, part_id, row_id);
+    assert(rc == RCOK);
+
+    new_row->set_value((int)CheckingConst::custid, (int64_t)custid);
+    new_row->set_value((int)CheckingConst::bal, sb_getBalance(thd_id));
+
+    index_insert(i_checking, idx_key, new_row, part_id);
+  }
+}
+
+RC smallbank_wl::get_txn_man(txn_man*& txn_manager, thread_t* h_thd) {
+  txn_manager = (smallbank_txn_man*)mem_allocator.alloc(
+      sizeof(smallbank_txn_man), h_thd->get_thd_id());
+  new (txn_manager) smallbank_txn_man();
+  txn_manager->init(h_thd, this, h_thd->get_thd_id());
+  return RCOK;
+}
+
+void* smallbank_wl::threadInitTable(void* This) {
+  smallbank_wl* wl = (smallbank_wl*)This;
+  int tid = ATOM_FETCH_ADD(wl->next_tid, 1);
+  assert(tid < (int)g_thread_cnt);
+
+#if CC_ALG == MICA
+  ::mica::util::lcore.pin_thread(tid);
+  while (__sync_lock_test_and_set(&wl->tid_lock[tid], 1) == 1) usleep(100);
+  wl->mica_db->activate(static_cast<uint16_t>(tid));
+#else
+  set_affinity(tid);
+#endif
+
+  mem_allocator.register_thread(tid);
+
+  uint64_t slice_size =
+      (g_sb_num_accounts + g_init_parallelism - 1) / g_init_parallelism;
+  uint64_t slice_offset = std::min(slice_size * tid, g_sb_num_accounts);
+  if (slice_offset + slice_size >= g_sb_num_accounts)
+    slice_size = g_sb_num_accounts - slice_offset;
+  for (uint64_t custid = slice_offset; custid < slice_offset + slice_size;
+       custid++)
+    wl->gen_account(custid, tid);
+
+#if CC_ALG == MICA
+  wl->mica_db->deactivate(static_cast<uint16_t>(tid));
+  __sync_lock_release(&wl->tid_lock[tid]);
+#endif
+  return NULL;
+}
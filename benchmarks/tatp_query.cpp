@@ -26,6 +26,22 @@ void tatp_query::init(uint64_t thd_id, workload* h_wl) {
     assert(false);
 }
 
+uint32_t tatp_query::trace_size() {
+  return trace_align(sizeof(type)) + trace_align(sizeof(args));
+}
+
+void tatp_query::trace_encode(char* buf) {
+  uint32_t pos = 0;
+  trace_put(buf, pos, &type, sizeof(type));
+  trace_put(buf, pos, &args, sizeof(args));
+}
+
+void tatp_query::trace_decode(char* buf) {
+  uint32_t pos = 0;
+  memcpy(&type, trace_get(buf, pos, sizeof(type)), sizeof(type));
+  memcpy(&args, trace_get(buf, pos, sizeof(args)), sizeof(args));
+}
+
 void tatp_query::gen_delete_call_forwarding(uint64_t thd_id) {
   type = TATPTxnType::DeleteCallForwarding;
   auto& arg = args.delete_call_forwarding;
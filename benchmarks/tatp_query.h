@@ -56,6 +56,10 @@ enum class TATPTxnType {
 class tatp_query : public base_query {
  public:
   void init(uint64_t thd_id, workload* h_wl);
+  void gen(uint64_t thd_id, workload* h_wl) { init(thd_id, h_wl); }
+  uint32_t trace_size();
+  void trace_encode(char* buf);
+  void trace_decode(char* buf);
 
   TATPTxnType type;
   union {
@@ -46,6 +46,12 @@ class tpcc_wl : public workload {
 
   uint32_t tid_lock[256];
 
+#if TPCC_CHECK
+  // [TPCC_CHECK] verifies the consistency conditions of all the warehouses
+  // in parallel after the run. Returns the # of violations.
+  uint64_t check_consistency();
+#endif
+
  private:
   uint64_t num_wh;
   void init_tab_item();
@@ -67,15 +73,51 @@ class tpcc_wl : public workload {
   static void* threadInitOrder(void* This);
 
   static void* threadInitWarehouse(void* This);
+
+#if TPCC_CHECK
+  uint64_t check_wh(uint64_t w_id, row_t* cold_buf);
+  static void* threadCheck(void* This);
+  uint64_t check_violation_cnt;
+#endif
 };
 
+#if TPCC_CHECK && (CC_ALG == MICA || CC_ALG == HEKATON || CC_ALG == MVCC)
+#error "TPCC_CHECK reads the rows in place and does not support multi-version CC_ALGs"
+#endif
+
+// frozen rows are repointed in the ordered indexes only if every row of
+// ORDER and ORDER-LINE has its entries, from the loader and the txns.
+#if COLD_STORE && TPCC_FULL != TPCC_INSERT_INDEX
+#error "COLD_STORE requires TPCC_FULL and TPCC_INSERT_INDEX to be equal"
+#endif
+
+#if CH_OLAP_THREAD_CNT != 0
+#if !ROW_HEAP || TPCC_CF || !(CC_ALG == NO_WAIT || CC_ALG == WAIT_DIE \
+    || CC_ALG == DL_DETECT || CC_ALG == SILO || CC_ALG == TICTOC \
+    || CC_ALG == HEKATON || CC_ALG == HSTORE)
+#error "CH_OLAP_THREAD_CNT requires ROW_HEAP, no TPCC_CF and a CC_ALG supported by table_scan"
+#endif
+#endif
+
 class tpcc_txn_man : public txn_man {
  public:
   void init(thread_t* h_thd, workload* h_wl, uint64_t part_id);
   RC run_txn(base_query* query);
+#if CH_OLAP_THREAD_CNT != 0
+  // [CH_BENCH] runs an analytical query over all the warehouses as a txn.
+  RC run_ch_query(CHQueryType type);
+#endif
 
  private:
   tpcc_wl* _wl;
+#if CH_OLAP_THREAD_CNT != 0
+  RC run_ch_q1();
+  RC run_ch_q6();
+  RC run_ch_q11();
+  RC run_ch_q14();
+  // per-item sums of CH-Q11.
+  uint64_t* ch_order_cnt;
+#endif
   RC run_payment(tpcc_query* m_query);
   RC run_new_order(tpcc_query* m_query);
   RC run_order_status(tpcc_query* query);
@@ -97,6 +139,9 @@ class tpcc_txn_man : public txn_man {
   ActiveDelivery active_delivery[NUM_WH];
 #endif
 
+  row_t* customer_findByLastName(uint64_t w_id, uint64_t d_id,
+                                 const char* c_last);
+
   row_t* payment_getWarehouse(uint64_t w_id);
   void payment_updateWarehouseBalance(row_t* row, double h_amount);
   row_t* payment_getDistrict(uint64_t d_w_id, uint64_t d_id);
@@ -0,0 +1,167 @@
+#include "tpcc.h"
+#include "tpcc_helper.h"
+#include "wl.h"
+#include "table.h"
+#include "row.h"
+#include "index_hash.h"
+#include "index_mbtree.h"
+#include "tpcc_const.h"
+#include "mem_alloc.h"
+
+// [CH_BENCH] CH-benCHmark queries over the TPC-C tables. Delivery dates are
+// 0 for undelivered order lines, so the date ranges of the spec become
+// "delivered". The results are folded into ch_result so that the
+// aggregation is not optimized away.
+
+#if CH_OLAP_THREAD_CNT != 0
+
+#include "table_scan.h"
+
+static volatile double ch_result;
+
+RC tpcc_txn_man::run_ch_query(CHQueryType type) {
+  switch (type) {
+    case CH_Q1:
+      return run_ch_q1();
+    case CH_Q6:
+      return run_ch_q6();
+    case CH_Q11:
+      return run_ch_q11();
+    case CH_Q14:
+      return run_ch_q14();
+    default:
+      assert(false);
+      return ERROR;
+  }
+}
+
+RC tpcc_txn_man::run_ch_q1() {
+  // SELECT OL_NUMBER, SUM(OL_QUANTITY), SUM(OL_AMOUNT), AVG(OL_QUANTITY), AVG(OL_AMOUNT), COUNT(*)
+  // FROM ORDER_LINE WHERE OL_DELIVERY_D > ? GROUP BY OL_NUMBER ORDER BY OL_NUMBER
+  struct Group {
+    uint64_t sum_qty;
+    double sum_amount;
+    uint64_t cnt;
+  } groups[15 + 1];
+  memset(groups, 0, sizeof(groups));
+
+  table_t* table = _wl->t_orderline;
+  table_scan scan;
+  scan.init(this, table, 0, table->get_part_cnt(), true);
+  scan.add_pred("OL_DELIVERY_D", SCAN_GT, (int64_t)0);
+  while (true) {
+    row_t* row;
+    if (scan.next(row) == Abort) return finish(Abort);
+    if (row == NULL) break;
+    uint64_t ol_number, ol_quantity;
+    double ol_amount;
+    row->get_value(OL_NUMBER, ol_number);
+    row->get_value(OL_QUANTITY, ol_quantity);
+    row->get_value(OL_AMOUNT, ol_amount);
+    scan.release();
+
+    assert(ol_number >= 1 && ol_number <= 15);
+    groups[ol_number].sum_qty += ol_quantity;
+    groups[ol_number].sum_amount += ol_amount;
+    groups[ol_number].cnt++;
+  }
+
+  double result = 0;
+  for (uint64_t ol_number = 1; ol_number <= 15; ol_number++) {
+    auto& g = groups[ol_number];
+    if (g.cnt == 0) continue;
+    result += (double)g.sum_qty / g.cnt + g.sum_amount / g.cnt;
+  }
+  ch_result = result;
+  return finish(RCOK);
+}
+
+RC tpcc_txn_man::run_ch_q6() {
+  // SELECT SUM(OL_AMOUNT) FROM ORDER_LINE
+  // WHERE OL_DELIVERY_D >= ? AND OL_DELIVERY_D < ? AND OL_QUANTITY BETWEEN 1 AND 100000
+  table_t* table = _wl->t_orderline;
+  table_scan scan;
+  scan.init(this, table, 0, table->get_part_cnt(), true);
+  scan.add_pred("OL_DELIVERY_D", SCAN_GT, (int64_t)0);
+  scan.add_pred("OL_QUANTITY", SCAN_GE, (int64_t)1);
+  scan.add_pred("OL_QUANTITY", SCAN_LE, (int64_t)100000);
+  double revenue = 0;
+  while (true) {
+    row_t* row;
+    if (scan.next(row) == Abort) return finish(Abort);
+    if (row == NULL) break;
+    double ol_amount;
+    row->get_value(OL_AMOUNT, ol_amount);
+    scan.release();
+    revenue += ol_amount;
+  }
+  ch_result = revenue;
+  return finish(RCOK);
+}
+
+RC tpcc_txn_man::run_ch_q11() {
+  // SELECT S_I_ID, SUM(S_ORDER_CNT) AS ORDERCOUNT FROM STOCK GROUP BY S_I_ID
+  // HAVING SUM(S_ORDER_CNT) > (SELECT SUM(S_ORDER_CNT) * .005 FROM STOCK)
+  // ORDER BY ORDERCOUNT DESC
+  // The SUPPLIER and NATION join of the spec is dropped (the tables do not
+  // exist here), and the qualifying items are counted instead of sorted.
+  if (ch_order_cnt == NULL)
+    ch_order_cnt = (uint64_t*)mem_allocator.alloc(
+        sizeof(uint64_t) * (g_max_items + 1), get_thd_id());
+  memset(ch_order_cnt, 0, sizeof(uint64_t) * (g_max_items + 1));
+
+  table_t* table = _wl->t_stock;
+  table_scan scan;
+  scan.init(this, table, 0, table->get_part_cnt(), true);
+  uint64_t total = 0;
+  while (true) {
+    row_t* row;
+    if (scan.next(row) == Abort) return finish(Abort);
+    if (row == NULL) break;
+    uint64_t s_i_id, s_order_cnt;
+    row->get_value(S_I_ID, s_i_id);
+    row->get_value(S_ORDER_CNT, s_order_cnt);
+    scan.release();
+
+    assert(s_i_id >= 1 && s_i_id <= g_max_items);
+    ch_order_cnt[s_i_id] += s_order_cnt;
+    total += s_order_cnt;
+  }
+
+  uint64_t item_cnt = 0;
+  for (uint64_t i_id = 1; i_id <= g_max_items; i_id++)
+    if (ch_order_cnt[i_id] > total * .005) item_cnt++;
+  ch_result = item_cnt;
+  return finish(RCOK);
+}
+
+RC tpcc_txn_man::run_ch_q14() {
+  // SELECT 100.00 * SUM(CASE WHEN I_DATA LIKE 'PR%' THEN OL_AMOUNT ELSE 0 END) / (1 + SUM(OL_AMOUNT))
+  // FROM ORDER_LINE, ITEM WHERE OL_I_ID = I_ID AND OL_DELIVERY_D >= ? AND OL_DELIVERY_D < ?
+  table_t* table = _wl->t_orderline;
+  table_scan scan;
+  scan.init(this, table, 0, table->get_part_cnt(), true);
+  scan.add_pred("OL_DELIVERY_D", SCAN_GT, (int64_t)0);
+  double promo = 0;
+  double revenue = 0;
+  while (true) {
+    row_t* row;
+    if (scan.next(row) == Abort) return finish(Abort);
+    if (row == NULL) break;
+    uint64_t ol_i_id;
+    double ol_amount;
+    row->get_value(OL_I_ID, ol_i_id);
+    row->get_value(OL_AMOUNT, ol_amount);
+    scan.release();
+
+    // ITEM is never written.
+    auto item = search(_wl->i_item, itemKey(ol_i_id), 0, PEEK);
+    if (item == NULL) return finish(Abort);
+    if (strncmp(item->get_value(I_DATA), "PR", 2) == 0) promo += ol_amount;
+    revenue += ol_amount;
+  }
+  ch_result = 100. * promo / (1 + revenue);
+  return finish(RCOK);
+}
+
+#endif
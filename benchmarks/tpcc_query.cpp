@@ -7,11 +7,16 @@
 #include "table.h"
 
 void tpcc_query::init(uint64_t thd_id, workload* h_wl) {
+  part_to_access =
+      (uint64_t*)mem_allocator.alloc(sizeof(uint64_t) * g_part_cnt, thd_id);
+  items = NULL;
+  gen(thd_id, h_wl);
+}
+
+void tpcc_query::gen(uint64_t thd_id, workload* h_wl) {
   // RNG will use thread-specific states (thd_id) because multiple threads may make a request to the same warehouse.
 
   double x = (double)URand(0, 99, thd_id) / 100.0;
-  part_to_access =
-      (uint64_t*)mem_allocator.alloc(sizeof(uint64_t) * g_part_cnt, thd_id);
 #if !TPCC_FULL
   if (x < g_perc_payment)
     gen_payment(thd_id);
@@ -36,6 +41,42 @@ void tpcc_query::init(uint64_t thd_id, workload* h_wl) {
 #endif
 }
 
+uint32_t tpcc_query::trace_size() {
+  uint32_t size = trace_align(sizeof(part_num)) + trace_align(sizeof(type)) +
+                  trace_align(sizeof(args)) +
+                  trace_align(sizeof(uint64_t) * part_num);
+  if (type == TPCC_NEW_ORDER)
+    size += trace_align(sizeof(Item_no) * args.new_order.ol_cnt);
+  return size;
+}
+
+void tpcc_query::trace_encode(char* buf) {
+  uint32_t pos = 0;
+  trace_put(buf, pos, &part_num, sizeof(part_num));
+  trace_put(buf, pos, &type, sizeof(type));
+  trace_put(buf, pos, &args, sizeof(args));
+  trace_put(buf, pos, part_to_access, sizeof(uint64_t) * part_num);
+  if (type == TPCC_NEW_ORDER)
+    trace_put(buf, pos, args.new_order.items,
+              sizeof(Item_no) * args.new_order.ol_cnt);
+}
+
+void tpcc_query::trace_decode(char* buf) {
+  uint32_t pos = 0;
+  part_num = *(uint64_t*)trace_get(buf, pos, sizeof(part_num));
+  type = *(TPCCTxnType*)trace_get(buf, pos, sizeof(type));
+  memcpy(&args, trace_get(buf, pos, sizeof(args)), sizeof(args));
+  part_to_access = (uint64_t*)trace_get(buf, pos, sizeof(uint64_t) * part_num);
+  if (type == TPCC_NEW_ORDER)
+    args.new_order.items = (Item_no*)trace_get(
+        buf, pos, sizeof(Item_no) * args.new_order.ol_cnt);
+
+#if WORKLOAD == TPCC && TPCC_SPLIT_DELIVERY
+  sub_query_id = 0;
+  max_sub_query_id = type == TPCC_DELIVERY ? 10 : 1;
+#endif
+}
+
 void tpcc_query::gen_payment(uint64_t thd_id) {
   type = TPCC_PAYMENT;
   tpcc_query_payment& arg = args.payment;
@@ -112,7 +153,10 @@ void tpcc_query::gen_new_order(uint64_t thd_id) {
   arg.c_id = NURand(1023, 1, g_cust_per_dist, thd_id);
   arg.ol_cnt = URand(5, 15, thd_id);
   arg.o_entry_d = 2013;
-  arg.items = (Item_no*)mem_allocator.alloc(sizeof(Item_no) * arg.ol_cnt, thd_id);
+  // sized for the largest ol_cnt so that gen() can reuse it.
+  if (items == NULL)
+    items = (Item_no*)mem_allocator.alloc(sizeof(Item_no) * 15, thd_id);
+  arg.items = items;
   arg.all_local = true;
   part_to_access[0] = wh_to_part(arg.w_id);
   part_num = 1;
@@ -153,9 +197,13 @@ void tpcc_query::gen_new_order(uint64_t thd_id) {
       part_to_access[part_num++] = wh_to_part(arg.items[i].ol_supply_w_id);
   }
   // "1% of new order gives wrong itemid"
-  // We cannot do this because DBx1000 cannot distinguish user aborts from conflict aborts.
-  // if (URand(0, 99, thd_id) == 0)
-  //   arg.items[URand(0, arg.ol_cnt - 1, thd_id)].ol_i_id = -1;
+#if TPCC_SPEC
+  // the last item is unused; run_new_order() rolls the txn back on it.
+  arg.rollback = URand(1, 100, thd_id) == 1;
+  if (arg.rollback) arg.items[arg.ol_cnt - 1].ol_i_id = g_max_items + 1;
+#else
+  arg.rollback = false;
+#endif
 }
 
 void tpcc_query::gen_order_status(uint64_t thd_id) {
@@ -61,6 +61,10 @@ struct tpcc_query_delivery {
 class tpcc_query : public base_query {
  public:
   void init(uint64_t thd_id, workload* h_wl);
+  void gen(uint64_t thd_id, workload* h_wl);
+  uint32_t trace_size();
+  void trace_encode(char* buf);
+  void trace_decode(char* buf);
 
   TPCCTxnType type;
   union {
@@ -72,6 +76,8 @@ class tpcc_query : public base_query {
   } args;
 
  private:
+  // args.new_order.items of the last new-order generated.
+  Item_no* items;
   // warehouse id to partition id mapping
   //	uint64_t wh_to_part(uint64_t wid);
   void gen_payment(uint64_t thd_id);
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "typed_schema.h"
+
+// Typed mirrors of the tables in TPCC_full_schema.txt that the txns update.
+// Keep them in sync with the schema file; tpcc_wl::init_schema() checks them
+// against the loaded Catalog.
+
+typedef TypedSchema<
+	Col<int64_t>,		// W_ID
+	Col<char, 10>,		// W_NAME
+	Col<char, 20>,		// W_STREET_1
+	Col<char, 20>,		// W_STREET_2
+	Col<char, 20>,		// W_CITY
+	Col<char, 2>,		// W_STATE
+	Col<char, 9>,		// W_ZIP
+	Col<double>,		// W_TAX
+	Col<double, 8, 1>	// W_YTD
+> WarehouseSchema;
+
+typedef TypedSchema<
+	Col<int64_t>,		// D_ID
+	Col<int64_t>,		// D_W_ID
+	Col<char, 10>,		// D_NAME
+	Col<char, 20>,		// D_STREET_1
+	Col<char, 20>,		// D_STREET_2
+	Col<char, 20>,		// D_CITY
+	Col<char, 2>,		// D_STATE
+	Col<char, 9>,		// D_ZIP
+	Col<double>,		// D_TAX
+	Col<double, 8, 1>,	// D_YTD
+	Col<int64_t, 8, 2>	// D_NEXT_O_ID
+> DistrictSchema;
+
+typedef TypedSchema<
+	Col<int64_t>,		// C_ID
+	Col<int64_t>,		// C_D_ID
+	Col<int64_t>,		// C_W_ID
+	Col<char, 16>,		// C_FIRST
+	Col<char, 2>,		// C_MIDDLE
+	Col<char, 16>,		// C_LAST
+	Col<char, 20>,		// C_STREET_1
+	Col<char, 20>,		// C_STREET_2
+	Col<char, 20>,		// C_CITY
+	Col<char, 2>,		// C_STATE
+	Col<char, 9>,		// C_ZIP
+	Col<char, 16>,		// C_PHONE
+	Col<int64_t>,		// C_SINCE
+	Col<char, 2>,		// C_CREDIT
+	Col<double>,		// C_CREDIT_LIM
+	Col<double>,		// C_DISCOUNT
+	Col<double, 8, 1>,	// C_BALANCE
+	Col<double, 8, 1>,	// C_YTD_PAYMENT
+	Col<uint64_t, 8, 1>,	// C_PAYMENT_CNT
+	Col<uint64_t, 8, 1>,	// C_DELIVERY_CNT
+	Col<char, 500, 2>	// C_DATA
+> CustomerSchema;
+
+typedef TypedSchema<
+	Col<int64_t>,		// S_I_ID
+	Col<int64_t>,		// S_W_ID
+	Col<uint64_t, 8, 1>,	// S_QUANTITY
+	Col<char, 24>,		// S_DIST_01
+	Col<char, 24>,		// S_DIST_02
+	Col<char, 24>,		// S_DIST_03
+	Col<char, 24>,		// S_DIST_04
+	Col<char, 24>,		// S_DIST_05
+	Col<char, 24>,		// S_DIST_06
+	Col<char, 24>,		// S_DIST_07
+	Col<char, 24>,		// S_DIST_08
+	Col<char, 24>,		// S_DIST_09
+	Col<char, 24>,		// S_DIST_10
+	Col<uint64_t, 8, 1>,	// S_YTD
+	Col<uint64_t, 8, 1>,	// S_ORDER_CNT
+	Col<uint64_t, 8, 1>,	// S_REMOTE_CNT
+	Col<char, 50>		// S_DATA
+> StockSchema;
@@ -11,6 +11,7 @@
 #include "index_mica.h"
 #include "index_mbtree.h"
 #include "tpcc_const.h"
+#include "tpcc_schema.h"
 #include "mem_alloc.h"
 // #include <unordered_set>
 
@@ -25,6 +26,10 @@ void tpcc_txn_man::init(thread_t* h_thd, workload* h_wl, uint64_t thd_id) {
 #ifdef TPCC_DBX1000_SERIAL_DELIVERY
   memset(active_delivery, 0, sizeof(active_delivery));
 #endif
+
+#if CH_OLAP_THREAD_CNT != 0
+  ch_order_cnt = NULL;
+#endif
 }
 
 RC tpcc_txn_man::run_txn(base_query* query) {
@@ -96,6 +101,57 @@ RC tpcc_txn_man::run_txn(base_query* query) {
 
 static void FAIL_ON_ABORT() {}
 
+//////////////////////////////////////////////////////
+// Customer
+//////////////////////////////////////////////////////
+
+row_t* tpcc_txn_man::customer_findByLastName(uint64_t w_id, uint64_t d_id,
+                                             const char* c_last) {
+  // Returns the index entry of customer ceil(n/2) of the n customers named
+  // c_last ordered by C_FIRST, or NULL if there is none. The name columns are
+  // never updated, so they are peeked.
+  auto index = _wl->i_customer_last;
+  auto key = custNPKey(d_id, w_id, c_last);
+  auto part_id = wh_to_part(w_id);
+
+  row_t* rows[100];
+  size_t count = 100;
+  auto rc = index_read_multiple(index, key, rows, count, part_id);
+  if (rc != RCOK) {
+    assert(false);
+    return NULL;
+  }
+  assert(count != 100);
+
+  // custNPKey() hashes the last name; drop the colliding names.
+  char firsts[100][FIRSTNAME_LEN];
+  row_t* matches[100];
+  size_t n = 0;
+  for (size_t i = 0; i < count; i++) {
+#if !TPCC_CF
+    auto row = get_row(index, rows[i], part_id, PEEK);
+#else
+    const access_t cf_access_type[] = {PEEK, SKIP, SKIP};
+    auto row = get_row(index, rows[i], part_id, SKIP, cf_access_type);
+#endif
+    if (row == NULL) continue;
+    if (strncmp(get_field_ptr<CustomerSchema, C_LAST>(row), c_last,
+                LASTNAME_LEN) != 0)
+      continue;
+    // insertion sort by C_FIRST.
+    const char* first = get_field_ptr<CustomerSchema, C_FIRST>(row);
+    size_t j = n++;
+    for (; j > 0 && strncmp(firsts[j - 1], first, FIRSTNAME_LEN) > 0; j--) {
+      memcpy(firsts[j], firsts[j - 1], FIRSTNAME_LEN);
+      matches[j] = matches[j - 1];
+    }
+    memcpy(firsts[j], first, FIRSTNAME_LEN);
+    matches[j] = rows[i];
+  }
+  if (n == 0) return NULL;
+  return matches[(n - 1) / 2];
+}
+
 //////////////////////////////////////////////////////
 // Payment
 //////////////////////////////////////////////////////
@@ -115,9 +171,8 @@ row_t* tpcc_txn_man::payment_getWarehouse(uint64_t w_id) {
 
 void tpcc_txn_man::payment_updateWarehouseBalance(row_t* row, double h_amount) {
   // UPDATE WAREHOUSE SET W_YTD = W_YTD + ? WHERE W_ID = ?
-  double w_ytd;
-  row->get_value(W_YTD, w_ytd);
-  if (g_wh_update) row->set_value(W_YTD, w_ytd + h_amount);
+  double w_ytd = get_field<WarehouseSchema, W_YTD>(row);
+  if (g_wh_update) set_field<WarehouseSchema, W_YTD>(row, w_ytd + h_amount);
 }
 
 row_t* tpcc_txn_man::payment_getDistrict(uint64_t d_w_id, uint64_t d_id) {
@@ -135,9 +190,8 @@ row_t* tpcc_txn_man::payment_getDistrict(uint64_t d_w_id, uint64_t d_id) {
 
 void tpcc_txn_man::payment_updateDistrictBalance(row_t* row, double h_amount) {
   // UPDATE DISTRICT SET D_YTD = D_YTD + ? WHERE D_W_ID  = ? AND D_ID = ?
-  double d_ytd;
-  row->get_value(D_YTD, d_ytd);
-  row->set_value(D_YTD, d_ytd + h_amount);
+  double d_ytd = get_field<DistrictSchema, D_YTD>(row);
+  set_field<DistrictSchema, D_YTD>(row, d_ytd + h_amount);
 }
 
 row_t* tpcc_txn_man::payment_getCustomerByCustomerId(uint64_t w_id,
@@ -159,23 +213,11 @@ row_t* tpcc_txn_man::payment_getCustomerByLastName(uint64_t w_id, uint64_t d_id,
                                                    const char* c_last,
                                                    uint64_t* out_c_id) {
   // SELECT C_ID, C_FIRST, C_MIDDLE, C_LAST, C_STREET_1, C_STREET_2, C_CITY, C_STATE, C_ZIP, C_PHONE, C_SINCE, C_CREDIT, C_CREDIT_LIM, C_DISCOUNT, C_BALANCE, C_YTD_PAYMENT, C_PAYMENT_CNT, C_DATA FROM CUSTOMER WHERE C_W_ID = ? AND C_D_ID = ? AND C_LAST = ? ORDER BY C_FIRST;
-  // XXX: the list is not sorted. But let's assume it's sorted...
-  // The performance won't be much different.
   auto index = _wl->i_customer_last;
-  auto key = custNPKey(d_id, w_id, c_last);
   auto part_id = wh_to_part(w_id);
 
-  row_t* rows[100];
-  size_t count = 100;
-  auto rc = index_read_multiple(index, key, rows, count, part_id);
-  if (rc != RCOK) {
-    assert(false);
-    return NULL;
-  }
-  if (count == 0) return NULL;
-  assert(count != 100);
-
-  auto mid = rows[count / 2];
+  auto mid = customer_findByLastName(w_id, d_id, c_last);
+  if (mid == NULL) return NULL;
 #if !TPCC_CF
   auto local = get_row(index, mid, part_id, WR);
 #else
@@ -194,15 +236,12 @@ bool tpcc_txn_man::payment_updateCustomer(row_t* row, uint64_t c_id,
                                           double h_amount) {
   // UPDATE CUSTOMER SET C_BALANCE = ?, C_YTD_PAYMENT = ?, C_PAYMENT_CNT = ?, C_DATA = ? WHERE C_W_ID = ? AND C_D_ID = ? AND C_ID = ?
   // UPDATE CUSTOMER SET C_BALANCE = ?, C_YTD_PAYMENT = ?, C_PAYMENT_CNT = ? WHERE C_W_ID = ? AND C_D_ID = ? AND C_ID = ?
-  double c_balance;
-  row->get_value(C_BALANCE, c_balance);
-  row->set_value(C_BALANCE, c_balance - h_amount);
-  double c_ytd_payment;
-  row->get_value(C_YTD_PAYMENT, c_ytd_payment);
-  row->set_value(C_YTD_PAYMENT, c_ytd_payment + h_amount);
-  uint64_t c_payment_cnt;
-  row->get_value(C_PAYMENT_CNT, c_payment_cnt);
-  row->set_value(C_PAYMENT_CNT, c_payment_cnt + 1);
+  double c_balance = get_field<CustomerSchema, C_BALANCE>(row);
+  set_field<CustomerSchema, C_BALANCE>(row, c_balance - h_amount);
+  double c_ytd_payment = get_field<CustomerSchema, C_YTD_PAYMENT>(row);
+  set_field<CustomerSchema, C_YTD_PAYMENT>(row, c_ytd_payment + h_amount);
+  uint64_t c_payment_cnt = get_field<CustomerSchema, C_PAYMENT_CNT>(row);
+  set_field<CustomerSchema, C_PAYMENT_CNT>(row, c_payment_cnt + 1);
 
 #if TPCC_FULL
   const char* c_credit = row->get_value(C_CREDIT);
@@ -266,6 +305,13 @@ RC tpcc_txn_man::run_payment(tpcc_query* query) {
   }
 
   payment_updateWarehouseBalance(warehouse, arg.h_amount);
+#if TPCC_INSERT_ROWS
+  // the names are read before the rows are retired.
+  char w_name[11];
+  memcpy(w_name, warehouse->get_value(W_NAME), 10);
+  w_name[10] = '\0';
+#endif
+  retire_row(warehouse);
 
   auto district = payment_getDistrict(arg.w_id, arg.d_id);
   if (district == NULL) {
@@ -273,14 +319,28 @@ RC tpcc_txn_man::run_payment(tpcc_query* query) {
     return finish(Abort);
   };
   payment_updateDistrictBalance(district, arg.h_amount);
+#if TPCC_INSERT_ROWS
+  char d_name[11];
+  memcpy(d_name, district->get_value(D_NAME), 10);
+  d_name[10] = '\0';
+#endif
+  retire_row(district);
 
+#if TPCC_SPEC
+  // 15% of the customers belong to a remote warehouse.
+  auto c_w_id = arg.c_w_id;
+  auto c_d_id = arg.c_d_id;
+#else
+  auto c_w_id = arg.w_id;
+  auto c_d_id = arg.d_id;
+#endif
   auto c_id = arg.c_id;
   row_t* customer;
   if (!arg.by_last_name)
-    customer = payment_getCustomerByCustomerId(arg.w_id, arg.d_id, arg.c_id);
+    customer = payment_getCustomerByCustomerId(c_w_id, c_d_id, arg.c_id);
   else
     customer =
-        payment_getCustomerByLastName(arg.w_id, arg.d_id, arg.c_last, &c_id);
+        payment_getCustomerByLastName(c_w_id, c_d_id, arg.c_last, &c_id);
   if (customer == NULL) {
     FAIL_ON_ABORT();
     return finish(Abort);
@@ -292,16 +352,6 @@ RC tpcc_txn_man::run_payment(tpcc_query* query) {
   }
 
 #if TPCC_INSERT_ROWS
-  char w_name[11];
-  char* tmp_str = warehouse->get_value(W_NAME);
-  memcpy(w_name, tmp_str, 10);
-  w_name[10] = '\0';
-
-  char d_name[11];
-  tmp_str = district->get_value(D_NAME);
-  memcpy(d_name, tmp_str, 10);
-  d_name[10] = '\0';
-
   char h_data[25];
   strcpy(h_data, w_name);
   int length = strlen(h_data);
@@ -352,12 +402,11 @@ row_t* tpcc_txn_man::new_order_getDistrict(uint64_t d_id, uint64_t d_w_id) {
 void tpcc_txn_man::new_order_incrementNextOrderId(row_t* row,
                                                   int64_t* out_o_id) {
   // UPDATE DISTRICT SET D_NEXT_O_ID = ? WHERE D_ID = ? AND D_W_ID = ?
-  int64_t o_id;
-  row->get_value(D_NEXT_O_ID, o_id);
+  int64_t o_id = get_field<DistrictSchema, D_NEXT_O_ID>(row);
   // printf("%" PRIi64 "\n", o_id);
   *out_o_id = o_id;
   o_id++;
-  row->set_value(D_NEXT_O_ID, o_id);
+  set_field<DistrictSchema, D_NEXT_O_ID>(row, o_id);
 }
 
 row_t* tpcc_txn_man::new_order_getCustomer(uint64_t w_id, uint64_t d_id,
@@ -473,25 +522,21 @@ row_t* tpcc_txn_man::new_order_getStockInfo(uint64_t ol_i_id,
 void tpcc_txn_man::new_order_updateStock(row_t* row, uint64_t ol_quantity,
                                          bool remote) {
   // UPDATE STOCK SET S_QUANTITY = ?, S_YTD = ?, S_ORDER_CNT = ?, S_REMOTE_CNT = ? WHERE S_I_ID = ? AND S_W_ID = ?
-  uint64_t s_quantity;
-  row->get_value(S_QUANTITY, s_quantity);
-  uint64_t s_ytd;
-  uint64_t s_order_cnt;
-  row->get_value(S_YTD, s_ytd);
-  row->set_value(S_YTD, s_ytd + ol_quantity);
-  row->get_value(S_ORDER_CNT, s_order_cnt);
-  row->set_value(S_ORDER_CNT, s_order_cnt + 1);
+  uint64_t s_quantity = get_field<StockSchema, S_QUANTITY>(row);
+  uint64_t s_ytd = get_field<StockSchema, S_YTD>(row);
+  set_field<StockSchema, S_YTD>(row, s_ytd + ol_quantity);
+  uint64_t s_order_cnt = get_field<StockSchema, S_ORDER_CNT>(row);
+  set_field<StockSchema, S_ORDER_CNT>(row, s_order_cnt + 1);
   if (remote) {
-    uint64_t s_remote_cnt;
-    row->get_value(S_REMOTE_CNT, s_remote_cnt);
-    row->set_value(S_REMOTE_CNT, s_remote_cnt + 1);
+    uint64_t s_remote_cnt = get_field<StockSchema, S_REMOTE_CNT>(row);
+    set_field<StockSchema, S_REMOTE_CNT>(row, s_remote_cnt + 1);
   }
   uint64_t quantity;
   if (s_quantity > ol_quantity + 10)
     quantity = s_quantity - ol_quantity;
   else
     quantity = s_quantity - ol_quantity + 91;
-  row->set_value(S_QUANTITY, quantity);
+  set_field<StockSchema, S_QUANTITY>(row, quantity);
 }
 
 bool tpcc_txn_man::new_order_createOrderLine(
@@ -544,9 +589,11 @@ RC tpcc_txn_man::run_new_order(tpcc_query* query) {
         new_order_getItemInfo(arg.items[ol_number - 1].ol_i_id);
     // printf("ol_i_id %d\n", (int)arg.items[ol_number - 1].ol_i_id);
     if (items[ol_number - 1] == NULL) {
-      assert(false);
-      // FAIL_ON_ABORT();
-      return finish(Abort);
+      assert(arg.rollback);
+      // a user rollback completes the txn; it must not be retried.
+      INC_STATS_ALWAYS(get_thd_id(), tpcc_new_order_rollback, 1);
+      finish(Abort);
+      return RCOK;
     };
   }
 
@@ -568,6 +615,7 @@ RC tpcc_txn_man::run_new_order(tpcc_query* query) {
 
   int64_t o_id;
   new_order_incrementNextOrderId(district, &o_id);
+  retire_row(district);
 
   auto customer = new_order_getCustomer(arg.w_id, arg.d_id, arg.c_id);
   if (customer == NULL) {
@@ -648,23 +696,11 @@ row_t* tpcc_txn_man::order_status_getCustomerByLastName(uint64_t w_id,
                                                         const char* c_last,
                                                         uint64_t* out_c_id) {
   // SELECT C_ID, C_FIRST, C_MIDDLE, C_LAST, C_BALANCE FROM CUSTOMER WHERE C_W_ID = ? AND C_D_ID = ? AND C_LAST = ? ORDER BY C_FIRST
-  // XXX: the list is not sorted. But let's assume it's sorted...
-  // The performance won't be much different.
   auto index = _wl->i_customer_last;
-  auto key = custNPKey(d_id, w_id, c_last);
   auto part_id = wh_to_part(w_id);
 
-  row_t* rows[100];
-  size_t count = 100;
-  auto rc = index_read_multiple(index, key, rows, count, part_id);
-  if (rc != RCOK) {
-    assert(false);
-    return NULL;
-  }
-  if (count == 0) return NULL;
-  assert(count != 100);
-
-  auto mid = rows[count / 2];
+  auto mid = customer_findByLastName(w_id, d_id, c_last);
+  if (mid == NULL) return NULL;
 #if !TPCC_CF
 #if CC_ALG != MICA && !defined(EMULATE_SNAPSHOT_FOR_1VCC)
   auto local = get_row(index, mid, part_id, RD);
@@ -985,12 +1021,10 @@ bool tpcc_txn_man::delivery_updateCustomer(double ol_total, uint64_t c_id,
 #endif
   if (row == NULL) return false;
 
-  double c_balance;
-  uint64_t c_delivery_cnt;
-  row->get_value(C_BALANCE, c_balance);
-  row->set_value(C_BALANCE, c_balance + ol_total);
-  row->get_value(C_DELIVERY_CNT, c_delivery_cnt);
-  row->set_value(C_DELIVERY_CNT, c_delivery_cnt + 1);
+  double c_balance = get_field<CustomerSchema, C_BALANCE>(row);
+  set_field<CustomerSchema, C_BALANCE>(row, c_balance + ol_total);
+  uint64_t c_delivery_cnt = get_field<CustomerSchema, C_DELIVERY_CNT>(row);
+  set_field<CustomerSchema, C_DELIVERY_CNT>(row, c_delivery_cnt + 1);
   return true;
 }
 
@@ -1187,8 +1221,7 @@ bool tpcc_txn_man::stock_level_getStockCount(uint64_t ol_w_id, uint64_t ol_d_id,
 #endif
     if (row == NULL) return false;
 
-    uint64_t s_quantity;
-    row->get_value(S_QUANTITY, s_quantity);
+    uint64_t s_quantity = get_field<StockSchema, S_QUANTITY>(row);
     if (s_quantity < threshold) result++;
   }
 
@@ -8,6 +8,7 @@
 #include "index_btree.h"
 #include "index_mbtree.h"
 #include "index_mica.h"
+#include "tpcc_schema.h"
 #include "index_mica_mbtree.h"
 #include "tpcc_helper.h"
 #include "row.h"
@@ -16,6 +17,49 @@
 #include "mem_alloc.h"
 #include "tpcc_const.h"
 #include "catalog.h"
+#include "cold_store.h"
+
+#if COLD_STORE
+// a delivered order and its lines are never written again.
+static bool order_is_cold(row_t* row) {
+  int64_t o_carrier_id;
+  row->get_value(O_CARRIER_ID, o_carrier_id);
+  return o_carrier_id != 0;
+}
+static idx_key_t order_key(row_t* row) {
+  int64_t o_id, o_d_id, o_w_id;
+  row->get_value(O_ID, o_id);
+  row->get_value(O_D_ID, o_d_id);
+  row->get_value(O_W_ID, o_w_id);
+  return orderKey(o_id, o_d_id, o_w_id);
+}
+static idx_key_t order_cust_key(row_t* row) {
+  int64_t o_id, o_c_id, o_d_id, o_w_id;
+  row->get_value(O_ID, o_id);
+  row->get_value(O_C_ID, o_c_id);
+  row->get_value(O_D_ID, o_d_id);
+  row->get_value(O_W_ID, o_w_id);
+  return orderCustKey(o_id, o_c_id, o_d_id, o_w_id);
+}
+static bool orderline_is_cold(row_t* row) {
+  int64_t ol_delivery_d;
+  row->get_value(OL_DELIVERY_D, ol_delivery_d);
+  return ol_delivery_d != 0;
+}
+static idx_key_t orderline_key(row_t* row) {
+  int64_t ol_number, ol_o_id, ol_d_id, ol_w_id;
+  row->get_value(OL_NUMBER, ol_number);
+  row->get_value(OL_O_ID, ol_o_id);
+  row->get_value(OL_D_ID, ol_d_id);
+  row->get_value(OL_W_ID, ol_w_id);
+  return orderlineKey(ol_number, ol_o_id, ol_d_id, ol_w_id);
+}
+// HISTORY is insert-only.
+static bool history_is_cold(row_t* row) {
+  (void)row;
+  return true;
+}
+#endif
 
 RC tpcc_wl::init() {
   workload::init();
@@ -42,6 +86,11 @@ RC tpcc_wl::init_schema(const char* schema_file) {
   t_item = tables["ITEM"];
   t_stock = tables["STOCK"];
 
+  WarehouseSchema::check(t_warehouse->get_schema());
+  DistrictSchema::check(t_district->get_schema());
+  CustomerSchema::check(t_customer->get_schema());
+  StockSchema::check(t_stock->get_schema());
+
   i_item = hash_indexes["HASH_ITEM_IDX"];
   i_warehouse = hash_indexes["HASH_WAREHOUSE_IDX"];
   i_district = hash_indexes["HASH_DISTRICT_IDX"];
@@ -53,6 +102,19 @@ RC tpcc_wl::init_schema(const char* schema_file) {
   i_neworder = ordered_indexes["ORDERED_NEWORDER_IDX"];
   i_orderline = ordered_indexes["ORDERED_ORDERLINE_IDX"];
 
+#if COLD_STORE
+  t_order->enable_cold(order_is_cold);
+  t_orderline->enable_cold(orderline_is_cold);
+  t_history->enable_cold(history_is_cold);
+#if TPCC_FULL
+  // the loader (TPCC_FULL) and the txns (TPCC_INSERT_INDEX) create the
+  // entries of the ordered indexes, which are equal here (see tpcc.h).
+  t_order->cold->add_index(i_order, order_key);
+  t_order->cold->add_index(i_order_cust, order_cust_key);
+  t_orderline->cold->add_index(i_orderline, orderline_key);
+#endif
+#endif
+
   return RCOK;
 }
 
@@ -220,7 +282,7 @@ void tpcc_wl::init_tab_dist(uint64_t wid) {
     double d_ytd = 30000.00;
     row->set_value(D_TAX, tax);
     row->set_value(D_YTD, d_ytd);
-    row->set_value(D_NEXT_O_ID, uint64_t(3001));
+    row->set_value(D_NEXT_O_ID, uint64_t(g_cust_per_dist + 1));
 
     index_insert(i_district, distKey(did, wid), row, wh_to_part(wid));
   }
@@ -492,3 +554,133 @@ void* tpcc_wl::threadInitWarehouse(void* This) {
 #endif
   return NULL;
 }
+
+#if TPCC_CHECK
+#if TPCC_INSERT_ROWS && TPCC_INSERT_INDEX && TPCC_FULL
+// frozen rows are decoded into cold_buf.
+static row_t* check_row(row_t* row, row_t* cold_buf) {
+#if COLD_STORE
+  if (is_cold_ref(row)) {
+    ColdBlock* block = cold_ref_block(row);
+    cold_buf->table = block->table;
+    block->decode(cold_ref_slot(row), cold_buf->get_data());
+    return cold_buf;
+  }
+#endif
+  (void)cold_buf;
+  return row;
+}
+#endif
+
+uint64_t tpcc_wl::check_wh(uint64_t w_id, row_t* cold_buf) {
+  // The run is over, so the rows are read in place without a txn.
+  auto part_id = wh_to_part(w_id);
+  uint64_t violation_cnt = 0;
+  row_t* row;
+  RC rc = i_warehouse->index_read(NULL, warehouseKey(w_id), &row, part_id);
+  assert(rc == RCOK);
+  double w_ytd = get_field<WarehouseSchema, W_YTD>(row);
+  double d_ytd_sum = 0;
+
+  for (uint64_t d_id = 1; d_id <= DIST_PER_WARE; d_id++) {
+    rc = i_district->index_read(NULL, distKey(d_id, w_id), &row, part_id);
+    assert(rc == RCOK);
+    d_ytd_sum += get_field<DistrictSchema, D_YTD>(row);
+    int64_t d_next_o_id = get_field<DistrictSchema, D_NEXT_O_ID>(row);
+    (void)d_next_o_id;
+
+#if TPCC_INSERT_ROWS && TPCC_INSERT_INDEX && TPCC_FULL
+    // the loader (TPCC_FULL) and the txns (TPCC_INSERT_INDEX) index every
+    // order, so the ordered indexes can be walked.
+    // D_NEXT_O_ID - 1 = max(O_ID) = max(NO_O_ID). The keys order O_IDs
+    // descending, so the first entry of the district has the max.
+    size_t cnt = 1;
+    int64_t max_o_id = 0;
+    rc = i_order->index_read_range(NULL, orderKey(g_max_orderline, d_id, w_id),
+                                   orderKey(1, d_id, w_id), &row, cnt,
+                                   part_id);
+    if (rc == RCOK && cnt == 1)
+      check_row(row, cold_buf)->get_value(O_ID, max_o_id);
+    if (max_o_id != d_next_o_id - 1) {
+      printf("tpcc_check: w=%" PRIu64 " d=%" PRIu64 " D_NEXT_O_ID=%" PRId64
+             " max(O_ID)=%" PRId64 "\n",
+             w_id, d_id, d_next_o_id, max_o_id);
+      violation_cnt++;
+    }
+    cnt = 1;
+    rc = i_neworder->index_read_range(
+        NULL, neworderKey(g_max_orderline, d_id, w_id),
+        neworderKey(1, d_id, w_id), &row, cnt, part_id);
+    // all the new-orders of the district may have been delivered.
+    if (rc == RCOK && cnt == 1) {
+      int64_t max_no_o_id;
+      check_row(row, cold_buf)->get_value(NO_O_ID, max_no_o_id);
+      if (max_no_o_id != d_next_o_id - 1) {
+        printf("tpcc_check: w=%" PRIu64 " d=%" PRIu64 " D_NEXT_O_ID=%" PRId64
+               " max(NO_O_ID)=%" PRId64 "\n",
+               w_id, d_id, d_next_o_id, max_no_o_id);
+        violation_cnt++;
+      }
+    }
+
+    // every order below D_NEXT_O_ID exists and has O_OL_CNT order-lines.
+    for (int64_t o_id = 1; o_id < d_next_o_id; o_id++) {
+      int64_t o_ol_cnt = -1;
+      rc = i_order->index_read(NULL, orderKey(o_id, d_id, w_id), &row, part_id);
+      if (rc == RCOK) check_row(row, cold_buf)->get_value(O_OL_CNT, o_ol_cnt);
+      row_t* lines[16];
+      size_t line_cnt = 16;
+      rc = i_orderline->index_read_range(
+          NULL, orderlineKey(1, o_id, d_id, w_id),
+          orderlineKey(15, o_id, d_id, w_id), lines, line_cnt, part_id);
+      if (rc != RCOK) line_cnt = 0;
+      if (o_ol_cnt != (int64_t)line_cnt) {
+        printf("tpcc_check: w=%" PRIu64 " d=%" PRIu64 " o=%" PRId64
+               " O_OL_CNT=%" PRId64 " order-lines=%zu\n",
+               w_id, d_id, o_id, o_ol_cnt, line_cnt);
+        violation_cnt++;
+      }
+    }
+#endif
+  }
+
+  // W_YTD = sum(D_YTD). The amounts are whole numbers, so the sums are exact.
+  if (g_wh_update && w_ytd != d_ytd_sum) {
+    printf("tpcc_check: w=%" PRIu64 " W_YTD=%.2f sum(D_YTD)=%.2f\n", w_id,
+           w_ytd, d_ytd_sum);
+    violation_cnt++;
+  }
+  return violation_cnt;
+}
+
+void* tpcc_wl::threadCheck(void* This) {
+  tpcc_wl* wl = (tpcc_wl*)This;
+  uint32_t thd_cnt = std::min(g_num_wh, g_thread_cnt);
+  uint32_t tid = ATOM_FETCH_ADD(wl->next_tid, 1);
+  set_affinity(tid);
+  mem_allocator.register_thread(tid);
+
+  row_t* cold_buf = NULL;
+#if COLD_STORE
+  cold_buf = (row_t*)mem_allocator.alloc(row_t::max_alloc_size(), tid);
+  cold_buf->init(MAX_TUPLE_SIZE);
+#endif
+  uint64_t violation_cnt = 0;
+  for (uint64_t w_id = tid + 1; w_id <= g_num_wh; w_id += thd_cnt)
+    violation_cnt += wl->check_wh(w_id, cold_buf);
+  ATOM_ADD(wl->check_violation_cnt, violation_cnt);
+  return NULL;
+}
+
+uint64_t tpcc_wl::check_consistency() {
+  uint32_t thd_cnt = std::min(g_num_wh, g_thread_cnt);
+  next_tid = 0;
+  check_violation_cnt = 0;
+  pthread_t p_thds[thd_cnt];
+  for (uint32_t i = 0; i < thd_cnt; i++)
+    pthread_create(&p_thds[i], NULL, threadCheck, this);
+  for (uint32_t i = 0; i < thd_cnt; i++) pthread_join(p_thds[i], NULL);
+  printf("[summary] tpcc_check violations=%" PRIu64 "\n", check_violation_cnt);
+  return check_violation_cnt;
+}
+#endif
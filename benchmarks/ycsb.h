@@ -7,6 +7,7 @@
 #include "helper.h"
 
 class ycsb_query;
+class ycsb_request;
 
 class ycsb_wl : public workload {
  public:
@@ -16,6 +17,8 @@ class ycsb_wl : public workload {
   RC get_txn_man(txn_man*& txn_manager, thread_t* h_thd);
   int key_to_part(uint64_t key);
   HASH_INDEX* the_index;
+  // [YCSB_ORDERED_SCAN] the same keys as the_index.
+  ORDERED_INDEX* the_ordered_index;
   table_t* the_table;
 
  private:
@@ -38,6 +41,9 @@ class ycsb_txn_man : public txn_man {
   RC run_txn(base_query* query);
 
  private:
+#if YCSB_ORDERED_SCAN
+  RC run_scan(ycsb_request* req, int part_id, uint64_t& v);
+#endif
   uint64_t row_cnt;
   ycsb_wl* _wl;
 };
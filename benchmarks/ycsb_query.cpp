@@ -1,3 +1,4 @@
+#include <algorithm>
 #include "query.h"
 #include "ycsb_query.h"
 #include "mem_alloc.h"
@@ -5,8 +6,7 @@
 #include "ycsb.h"
 #include "table.h"
 
-uint64_t ycsb_query::the_n = 0;
-double ycsb_query::denom = 0;
+ZipfGen ycsb_query::zipf_gen;
 
 void ycsb_query::init(uint64_t thd_id, workload* h_wl, Query_thd* query_thd) {
   _query_thd = query_thd;
@@ -14,56 +14,88 @@ void ycsb_query::init(uint64_t thd_id, workload* h_wl, Query_thd* query_thd) {
       sizeof(ycsb_request) * g_req_per_query, thd_id);
   part_to_access =
       (uint64_t*)mem_allocator.alloc(sizeof(uint64_t) * g_part_per_txn, thd_id);
-  zeta_2_theta = zeta(2, g_zipf_theta);
-  assert(the_n != 0);
-  assert(denom != 0);
+  assert(zipf_gen.get_n() != 0);
   gen_requests(thd_id, h_wl);
 }
 
-void ycsb_query::calculateDenom() {
-  assert(the_n == 0);
+uint32_t ycsb_query::trace_size() {
+  return trace_align(sizeof(request_cnt)) + trace_align(sizeof(part_num)) +
+         trace_align(sizeof(ycsb_request) * request_cnt) +
+         trace_align(sizeof(uint64_t) * part_num);
+}
+
+void ycsb_query::trace_encode(char* buf) {
+  uint32_t pos = 0;
+  trace_put(buf, pos, &request_cnt, sizeof(request_cnt));
+  trace_put(buf, pos, &part_num, sizeof(part_num));
+  trace_put(buf, pos, requests, sizeof(ycsb_request) * request_cnt);
+  trace_put(buf, pos, part_to_access, sizeof(uint64_t) * part_num);
+}
+
+void ycsb_query::trace_decode(char* buf) {
+  uint32_t pos = 0;
+  request_cnt = *(uint64_t*)trace_get(buf, pos, sizeof(request_cnt));
+  part_num = *(uint64_t*)trace_get(buf, pos, sizeof(part_num));
+  requests =
+      (ycsb_request*)trace_get(buf, pos, sizeof(ycsb_request) * request_cnt);
+  part_to_access = (uint64_t*)trace_get(buf, pos, sizeof(uint64_t) * part_num);
+}
+
+void ycsb_query::init_zipf() {
   uint64_t table_size = g_synth_table_size / g_virtual_part_cnt;
-  // the_n = table_size - 1;
-  the_n = table_size;
-  denom = zeta(the_n, g_zipf_theta);
+  zipf_gen.init(table_size, g_zipf_theta);
 }
 
-// The following algorithm comes from the paper:
-// Quickly generating billion-record synthetic databases
-// However, it seems there is a small bug.
-// The original paper says zeta(theta, 2.0). But I guess it should be
-// zeta(2.0, theta).
-double ycsb_query::zeta(uint64_t n, double theta) {
-  double sum = 0;
-  for (uint64_t i = 1; i <= n; i++) sum += pow(1.0 / i, theta);
-  return sum;
+uint32_t ycsb_query::get_phase() {
+#if YCSB_PHASE_LEN != 0
+  uint64_t phase = (get_server_clock() - run_starttime) / (YCSB_PHASE_LEN * 1000000UL);
+  return (phase < YCSB_MAX_PHASE) ? phase : YCSB_MAX_PHASE - 1;
+#else
+  return 0;
+#endif
 }
 
 uint64_t ycsb_query::zipf(uint64_t n, double theta) {
-  assert(this->the_n == n);
-  assert(theta == g_zipf_theta);
-  double alpha = 1 / (1 - theta);
-  double zetan = denom;
-  double eta = (1 - pow(2.0 / n, 1 - theta)) / (1 - zeta_2_theta / zetan);
+  assert(zipf_gen.get_n() == n);
+  assert(zipf_gen.get_theta() == theta);
   double u;
   drand48_r(&_query_thd->buffer, &u);
-  double uz = u * zetan;
-  // if (uz < 1) return 1;
-  // if (uz < 1 + pow(0.5, theta)) return 2;
-  // return 1 + (uint64_t)(n * pow(eta*u -eta + 1, alpha));
-  if (uz < 1) return 0;
-  if (uz < 1 + pow(0.5, theta)) return 1;
-  uint64_t v = 0 + (uint64_t)(n * pow(eta * u - eta + 1, alpha));
-  if (v >= n) v = n - 1;
-  return v;
+  return zipf_gen.sample(u);
+}
+
+// The keys of a query are kept in a small sorted array.
+static bool find_key(uint64_t* keys, uint64_t key_cnt, uint64_t key) {
+  return std::binary_search(keys, keys + key_cnt, key);
+}
+
+static void insert_key(uint64_t* keys, uint64_t& key_cnt, uint64_t key) {
+  uint64_t* pos = std::lower_bound(keys, keys + key_cnt, key);
+  memmove(pos + 1, pos, (keys + key_cnt - pos) * sizeof(uint64_t));
+  *pos = key;
+  key_cnt++;
 }
 
 void ycsb_query::gen_requests(uint64_t thd_id, workload* h_wl) {
 #if CC_ALG == HSTORE
   assert(g_virtual_part_cnt == g_part_cnt);
+#endif
+  uint32_t phase = get_phase();
+  double read_perc = g_read_perc;
+  double write_perc = g_write_perc;
+  if (is_burst_phase(phase)) {
+    read_perc = 1 - YCSB_BURST_WRITE_PERC;
+    write_perc = YCSB_BURST_WRITE_PERC;
+  }
+  uint64_t table_size = g_synth_table_size / g_virtual_part_cnt;
+  // where the hottest key is in this phase.
+  uint64_t hot_row = phase * (uint64_t)YCSB_HOTSPOT_SHIFT % table_size;
+#if YCSB_LATEST
+  hot_row = (hot_row + (get_server_clock() - run_starttime) / 1000 *
+                           YCSB_LATEST_RATE / 1000000) % table_size;
 #endif
   int access_cnt = 0;
-  set<uint64_t> all_keys;
+  uint64_t all_keys[g_req_per_query * (SCAN_LEN > 1 ? SCAN_LEN : 1)];
+  uint64_t key_cnt = 0;
   part_num = 0;
   double r = 0;
   int64_t rint64 = 0;
@@ -94,22 +126,32 @@ void ycsb_query::gen_requests(uint64_t thd_id, workload* h_wl) {
     double r;
     drand48_r(&_query_thd->buffer, &r);
     ycsb_request* req = &requests[rid];
-    if (r < g_read_perc) {
+    if (r < read_perc) {
       req->rtype = RD;
-    } else if (r >= g_read_perc && r <= g_write_perc + g_read_perc) {
+    } else if (r >= read_perc && r <= write_perc + read_perc) {
       req->rtype = WR;
     } else {
       req->rtype = SCAN;
+#if YCSB_SCAN_LEN_UNIFORM
+      int64_t len;
+      lrand48_r(&_query_thd->buffer, &len);
+      req->scan_len = len % SCAN_LEN + 1;
+#else
       req->scan_len = SCAN_LEN;
+#endif
     }
 
     // the request will access part_id.
     uint64_t ith = tmp * part_num / g_req_per_query;
     uint64_t part_id = part_to_access[ith];
-    uint64_t table_size = g_synth_table_size / g_virtual_part_cnt;
     // uint64_t row_id = zipf(table_size - 1, g_zipf_theta);
     uint64_t row_id = zipf(table_size, g_zipf_theta);
     assert(row_id < table_size);
+#if YCSB_LATEST
+    row_id = (hot_row + table_size - row_id) % table_size;
+#else
+    row_id = (hot_row + row_id) % table_size;
+#endif
     uint64_t primary_key = row_id * g_virtual_part_cnt + part_id;
     req->key = primary_key;
     int64_t rint64;
@@ -119,23 +161,30 @@ void ycsb_query::gen_requests(uint64_t thd_id, workload* h_wl) {
     req->column = rint64 % FIELD_PER_TUPLE;
     // Make sure a single row is not accessed twice
     if (req->rtype == RD || req->rtype == WR) {
-      if (all_keys.find(req->key) == all_keys.end()) {
-        all_keys.insert(req->key);
+      if (!find_key(all_keys, key_cnt, req->key)) {
+        insert_key(all_keys, key_cnt, req->key);
         access_cnt++;
       } else
         continue;
     } else {
+      auto scan_key = [&](UInt32 i) {
+#if YCSB_ORDERED_SCAN
+        // the range [key, key + scan_len) of the ordered index.
+        return req->key + i;
+#else
+        return (row_id + i) * g_part_cnt + part_id;
+#endif
+      };
       bool conflict = false;
       for (UInt32 i = 0; i < req->scan_len; i++) {
-        primary_key = (row_id + i) * g_part_cnt + part_id;
-        if (all_keys.find(primary_key) != all_keys.end()) conflict = true;
+        if (find_key(all_keys, key_cnt, scan_key(i))) conflict = true;
       }
       if (conflict)
         continue;
       else {
         for (UInt32 i = 0; i < req->scan_len; i++)
-          all_keys.insert((row_id + i) * g_part_cnt + part_id);
-        access_cnt += SCAN_LEN;
+          insert_key(all_keys, key_cnt, scan_key(i));
+        access_cnt += req->scan_len;
       }
     }
     rid++;
@@ -4,6 +4,11 @@
 #include "global.h"
 #include "helper.h"
 #include "query.h"
+#include "zipf.h"
+
+#if (YCSB_PHASE_LEN != 0 || YCSB_LATEST) && !QUERY_STREAM
+#error "YCSB_PHASE_LEN and YCSB_LATEST need QUERY_STREAM"
+#endif
 
 class workload;
 class Query_thd;
@@ -24,7 +29,16 @@ class ycsb_query : public base_query {
  public:
   void init(uint64_t thd_id, workload* h_wl) { assert(false); };
   void init(uint64_t thd_id, workload* h_wl, Query_thd* query_thd);
-  static void calculateDenom();
+  void gen(uint64_t thd_id, workload* h_wl) { gen_requests(thd_id, h_wl); }
+  uint32_t trace_size();
+  void trace_encode(char* buf);
+  void trace_decode(char* buf);
+  static void init_zipf();
+  // [YCSB_PHASE] the phase of the run at the current time.
+  static uint32_t get_phase();
+  static bool is_burst_phase(uint32_t phase) {
+    return YCSB_BURST_INTVL != 0 && phase % YCSB_BURST_INTVL == YCSB_BURST_INTVL - 1;
+  }
 
   uint64_t request_cnt;
   ycsb_request* requests;
@@ -32,12 +46,9 @@ class ycsb_query : public base_query {
  private:
   void gen_requests(uint64_t thd_id, workload* h_wl);
   // for Zipfian distribution
-  static double zeta(uint64_t n, double theta);
   uint64_t zipf(uint64_t n, double theta);
 
-  static uint64_t the_n;
-  static double denom;
-  double zeta_2_theta;
+  static ZipfGen zipf_gen;
   Query_thd* _query_thd;
 };
 
@@ -39,6 +39,13 @@ RC ycsb_txn_man::run_txn(base_query* query) {
     ycsb_request* req = &m_query->requests[rid];
     int part_id = wl->key_to_part(req->key);
     uint64_t column = req->column;
+#if YCSB_ORDERED_SCAN
+    if (req->rtype == SCAN) {
+      rc = run_scan(req, part_id, v);
+      if (rc != RCOK) goto final;
+      continue;
+    }
+#endif
     bool finish_req = false;
     UInt32 iteration = 0;
     while (!finish_req) {
@@ -71,6 +78,9 @@ RC ycsb_txn_man::run_txn(base_query* query) {
           // char * data = row->get_data();
 #if !TPCC_CF
           char* data = row->get_data() + column * kColumnSize;
+#if DELTA_WRITE
+          row->mark_dirty(column * kColumnSize, kColumnSize);
+#endif
 #else
           char* data = row->cf_data[0] + column * kColumnSize;
 #endif
@@ -83,6 +93,7 @@ RC ycsb_txn_man::run_txn(base_query* query) {
           //*(uint64_t *)(&data[fid * 10]) = 0;
           // memcpy(data, v, column_size);
           //					}
+          retire_row(row);
         }
       }
 
@@ -96,3 +107,40 @@ final:
   rc = finish(rc);
   return rc;
 }
+
+#if YCSB_ORDERED_SCAN
+RC ycsb_txn_man::run_scan(ycsb_request* req, int part_id, uint64_t& v) {
+  const uint64_t kColumnSize = MAX_TUPLE_SIZE / FIELD_PER_TUPLE;
+  auto index = _wl->the_ordered_index;
+
+  // the range stops at the last key of the partition.
+  uint64_t rows_per_part = g_synth_table_size / g_part_cnt;
+  uint64_t end_key = std::min(req->key + req->scan_len,
+                              std::min((part_id + 1) * rows_per_part,
+                                       g_synth_table_size));
+  row_t* rows[SCAN_LEN];
+  size_t count = req->scan_len;
+  assert(count <= SCAN_LEN);
+  auto idx_rc = index_read_range(index, req->key, end_key - 1, rows, count,
+                                 part_id);
+  if (idx_rc != RCOK) return Abort;
+
+  for (size_t i = 0; i < count; i++) {
+#if CC_ALG != MICA
+    auto row = get_row(index, rows[i], part_id, RD);
+#else
+    auto row = get_row(index, rows[i], part_id, PEEK);
+#endif
+    if (row == NULL) return Abort;
+#if !TPCC_CF
+    const char* data = row->get_data() + req->column * kColumnSize;
+#else
+    const char* data = row->cf_data[0] + req->column * kColumnSize;
+#endif
+    for (uint64_t j = 0; j < kColumnSize; j += 64)
+      v += static_cast<uint64_t>(data[j]);
+    v += static_cast<uint64_t>(data[kColumnSize - 1]);
+  }
+  return RCOK;
+}
+#endif
@@ -27,11 +27,16 @@ RC ycsb_wl::init() {
   next_tid = 0;
   char* cpath = getenv("GRAPHITE_HOME");
   string path;
+#if YCSB_ORDERED_SCAN
+  const char* schema_name = "YCSB_scan_schema.txt";
+#else
+  const char* schema_name = "YCSB_schema.txt";
+#endif
   if (cpath == NULL)
-    path = "./benchmarks/YCSB_schema.txt";
+    path = string("./benchmarks/") + schema_name;
   else {
     path = string(cpath);
-    path += "/tests/apps/dbms/YCSB_schema.txt";
+    path += string("/tests/apps/dbms/") + schema_name;
   }
   init_schema(path);
 
@@ -52,6 +57,9 @@ RC ycsb_wl::init_schema(string schema_file) {
   workload::init_schema(schema_file);
   the_table = tables["MAIN_TABLE"];
   the_index = hash_indexes["HASH_MAIN_INDEX"];
+#if YCSB_ORDERED_SCAN
+  the_ordered_index = ordered_indexes["ORDERED_MAIN_INDEX"];
+#endif
   return RCOK;
 }
 
@@ -166,6 +174,9 @@ void* ycsb_wl::init_table_slice() {
     uint64_t idx_key = primary_key;
 
     index_insert(the_index, idx_key, new_row, part_id);
+#if YCSB_ORDERED_SCAN
+    index_insert(the_ordered_index, idx_key, new_row, part_id);
+#endif
 
     // 		if (key % 1000000 == 0) {
     // 			printf("key=%" PRIu64 "\n", key);
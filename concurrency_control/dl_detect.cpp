@@ -11,28 +11,69 @@
 // locks than all the other txns on the loop. 
 // In other words, the victim should be the txn that 
 // performs the least amount of work
+//
+// The detector has no global latch. Each waiting thread
+// publishes its own waits-for edges and runs the detection
+// itself; other threads' edges are read through a seqlock
+// snapshot so detection never blocks the lock holders.
 /********************************************************/
 void DL_detect::init() {
-	dependency = new DepThd[g_thread_cnt];
 	V = g_thread_cnt;
+	dependency = (DepThd *) mem_allocator.alloc(sizeof(DepThd) * V, 0);
+	for (int i = 0; i < V; i++) {
+		dependency[i].version = 0;
+		dependency[i].txnid = -1;
+		dependency[i].num_locks = 0;
+		dependency[i].adj_cnt = 0;
+		dependency[i].adj = (uint64_t *) mem_allocator.alloc(sizeof(uint64_t) * V, 0);
+		dependency[i].edge_buf = (uint64_t *) mem_allocator.alloc(sizeof(uint64_t) * V, 0);
+		dependency[i].visited = (bool *) mem_allocator.alloc(sizeof(bool) * V, 0);
+		dependency[i].recStack = (bool *) mem_allocator.alloc(sizeof(bool) * V, 0);
+	}
 }
 
 int
 DL_detect::add_dep(uint64_t txnid1, uint64_t * txnids, int cnt, int num_locks) {
 	if (g_no_dl)
 		return 0;
+	assert(cnt <= V);
 	int thd1 = get_thdid_from_txnid(txnid1);
-	pthread_mutex_lock( &dependency[thd1].lock );
-	dependency[thd1].txnid = txnid1;
-	dependency[thd1].num_locks = num_locks;
-	
+	DepThd * dep = &dependency[thd1];
+	// only the owner thread writes its own entry.
+	dep->version ++;
+	COMPILER_BARRIER
+	dep->txnid = txnid1;
+	dep->num_locks = num_locks;
 	for (int i = 0; i < cnt; i++) 
-		dependency[thd1].adj.push_back(txnids[i]);
-	
-	pthread_mutex_unlock( &dependency[thd1].lock );
+		dep->adj[i] = txnids[i];
+	dep->adj_cnt = cnt;
+	COMPILER_BARRIER
+	dep->version ++;
 	return 0;
 }
 
+int64_t
+DL_detect::snapshot(int thd, uint64_t * txnids, int &cnt, int &num_locks) {
+	DepThd * dep = &dependency[thd];
+	int64_t txnid;
+	while (true) {
+		uint64_t version = dep->version;
+		if (version & 1) {
+			PAUSE
+			continue;
+		}
+		COMPILER_BARRIER
+		txnid = dep->txnid;
+		num_locks = dep->num_locks;
+		cnt = dep->adj_cnt;
+		for (int i = 0; i < cnt; i++)
+			txnids[i] = dep->adj[i];
+		COMPILER_BARRIER
+		if (dep->version == version)
+			return txnid;
+	}
+}
+
 bool 
 DL_detect::nextNode(uint64_t txnid, DetectData * detect_data) {
 	int thd = get_thdid_from_txnid(txnid);
@@ -40,31 +81,21 @@ DL_detect::nextNode(uint64_t txnid, DetectData * detect_data) {
 	detect_data->visited[thd] = true;
 	detect_data->recStack[thd] = true;
 	
-	pthread_mutex_lock( &dependency[thd].lock );
-	
-	int lock_num = dependency[thd].num_locks;
-	int txnid_num = dependency[thd].adj.size();
-	uint64_t txnids[ txnid_num ];
-	int n = 0;
+	int lock_num;
+	int txnid_num;
+	uint64_t txnids[ V ];
 	
-	if (dependency[thd].txnid != (SInt64)txnid) {
+	if (snapshot(thd, txnids, txnid_num, lock_num) != (SInt64)txnid) {
 		detect_data->recStack[thd] = false;
-		pthread_mutex_unlock( &dependency[thd].lock );
 		return false;
 	}
-	
-	for(list<uint64_t>::iterator i = dependency[thd].adj.begin(); i != dependency[thd].adj.end(); ++i) {
-		txnids[n++] = *i;
-	}
-	
-	pthread_mutex_unlock( &dependency[thd].lock );
 
-	for (n = 0; n < txnid_num; n++) {
+	for (int n = 0; n < txnid_num; n++) {
 		int nextthd = get_thdid_from_txnid( txnids[n] );
 
 		// next node not visited and txnid is not stale
 		if ( detect_data->recStack[nextthd] ) {
-			if ((SInt32)txnids[n] == dependency[nextthd].txnid) {
+			if ((SInt64)txnids[n] == dependency[nextthd].txnid) {
 				detect_data->loop = true;
 				detect_data->onloop = true;
 				detect_data->loopstart = nextthd;
@@ -106,34 +137,29 @@ DL_detect::detect_cycle(uint64_t txnid) {
 	bool deadlock = false;
 
 	int thd = get_thdid_from_txnid(txnid);
-	DetectData * detect_data = (DetectData *)
-		mem_allocator.alloc(sizeof(DetectData), thd);
-	detect_data->visited = (bool * )
-		mem_allocator.alloc(sizeof(bool) * V, thd);
-	detect_data->recStack = (bool * )
-		mem_allocator.alloc(sizeof(bool) * V, thd);	
-	for(int i = 0; i < V; i++) {
-        detect_data->visited[i] = false;
-		detect_data->recStack[i] = false;
-	}
+	DetectData detect_data;
+	// the scratch space is owned by the detecting thread.
+	detect_data.visited = dependency[thd].visited;
+	detect_data.recStack = dependency[thd].recStack;
+	memset(detect_data.visited, 0, sizeof(bool) * V);
+	memset(detect_data.recStack, 0, sizeof(bool) * V);
 
-	detect_data->min_lock_num = 1000;
-	detect_data->min_txnid = -1;
-	detect_data->loop = false;
+	detect_data.min_lock_num = 1000;
+	detect_data.min_txnid = -1;
+	detect_data.loop = false;
+	detect_data.onloop = false;
+	detect_data.loopstart = -1;
 
-	if ( isCyclic(txnid, detect_data) ){ 
+	if ( isCyclic(txnid, &detect_data) ){ 
 		deadlock = true;
 		INC_GLOB_STATS(deadlock, 1);
-		int thd_to_abort = get_thdid_from_txnid(detect_data->min_txnid);
-		if (dependency[thd_to_abort].txnid == (SInt64) detect_data->min_txnid) {
+		int thd_to_abort = get_thdid_from_txnid(detect_data.min_txnid);
+		if (dependency[thd_to_abort].txnid == (SInt64) detect_data.min_txnid) {
 			txn_man * txn = glob_manager->get_txn_man(thd_to_abort);
 			txn->lock_abort = true;
 		}
 	} 
 	
-	mem_allocator.free(detect_data->visited, sizeof(bool)*V);
-	mem_allocator.free(detect_data->recStack, sizeof(bool)*V);
-	mem_allocator.free(detect_data, sizeof(DetectData));
 	uint64_t timespan = get_sys_clock() - starttime;
 	INC_GLOB_STATS(dl_detect_time, timespan);
 	if (deadlock) return 1;
@@ -144,12 +170,12 @@ void DL_detect::clear_dep(uint64_t txnid) {
 	if (g_no_dl)
 		return;
 	int thd = get_thdid_from_txnid(txnid);
-	pthread_mutex_lock( &dependency[thd].lock );
-	
-	dependency[thd].adj.clear();
-	dependency[thd].txnid = -1;
-	dependency[thd].num_locks = 0;
-	
-	pthread_mutex_unlock( &dependency[thd].lock );
+	DepThd * dep = &dependency[thd];
+	dep->version ++;
+	COMPILER_BARRIER
+	dep->adj_cnt = 0;
+	dep->txnid = -1;
+	dep->num_locks = 0;
+	COMPILER_BARRIER
+	dep->version ++;
 }
-
@@ -2,20 +2,25 @@
 #define _DL_DETECT_
 
 #include <limits.h>
-#include <list>
 #include <stdint.h>
-#include "pthread.h"
 #include "config.h"
 //#include "global.h"
 //#include "helper.h"
 
-// The denpendency information per thread
+// The denpendency information per thread.
+// Only the owner thread writes its DepThd. Other threads take a consistent
+// snapshot without any latch by checking the version (seqlock).
 struct DepThd {
-    std::list<uint64_t> adj;    // Pointer to an array containing adjacency lists
-	pthread_mutex_t lock; 
-	volatile int64_t txnid; 				// -1 means invalid
-	int num_locks;				// the # of locks that txn is currently holding
-	char pad[2 * CL_SIZE - sizeof(int64_t) - sizeof(pthread_mutex_t) - sizeof(std::list<uint64_t>) - sizeof(int)];
+	volatile uint64_t version;	// odd while the owner thread is updating
+	volatile int64_t txnid; 	// -1 means invalid
+	volatile int num_locks;		// the # of locks that txn is currently holding
+	volatile int adj_cnt;
+	uint64_t * adj;				// waits-for edges (txnids), g_thread_cnt entries
+	// the following are only used by the owner thread
+	uint64_t * edge_buf;		// filled by Row_lock::lock_get()
+	bool * visited;
+	bool * recStack;
+	char pad[CL_SIZE - sizeof(uint64_t) * 2 - sizeof(int) * 2 - sizeof(void *) * 4];
 };
 
 // shared data for a particular deadlock detection
@@ -32,27 +37,28 @@ struct DetectData {
 class DL_detect {
 public:
 	void init();
-	// return values: 
+	// return values:
 	// 	0: no deadlocks
 	//  1: deadlock exists
 	int detect_cycle(uint64_t txnid);
 	// txn1 (txn_id) dependes on txns (containing cnt txns)
+	// replaces the previous dependencies of txn1.
 	// return values:
 	//	0: succeed.
-	//	16: cannot get lock
 	int add_dep(uint64_t txnid, uint64_t * txnids, int cnt, int num_locks);
 	// remove all outbound dependencies for txnid.
-	// will wait for the lock until acquired.
 	void clear_dep(uint64_t txnid);
+	// per-thread buffer (g_thread_cnt entries) to collect the txnids to wait for.
+	uint64_t * get_edge_buf(uint64_t thd_id) { return dependency[thd_id].edge_buf; }
 private:
 	int V;    // No. of vertices
 	DepThd * dependency;
-	
+
 	///////////////////////////////////////////
 	// For deadlock detection
 	///////////////////////////////////////////
-	// dl_lock is the global lock. Only used when deadlock detection happens
-	pthread_mutex_t _lock;
+	// take a consistent snapshot of thd's dependency. returns the txnid.
+	int64_t snapshot(int thd, uint64_t * txnids, int &cnt, int &num_locks);
 	// return value: whether a loop is detected.
 	bool nextNode(uint64_t txnid, DetectData * detect_data);
 	bool isCyclic(uint64_t txnid, DetectData * detect_data); // return if "thd" is causing a cycle
@@ -2,6 +2,7 @@
 #include "row.h"
 #include "row_hekaton.h"
 #include "manager.h"
+#include "thread.h"
 
 #if CC_ALG==HEKATON
 
@@ -10,7 +11,7 @@ txn_man::validate_hekaton(RC rc)
 {
 	uint64_t starttime = get_sys_clock();
 	INC_STATS(get_thd_id(), debug1, get_sys_clock() - starttime);
-	ts_t commit_ts = glob_manager->get_ts(get_thd_id());
+	ts_t commit_ts = h_thd->get_commit_ts();
 	// validate the read set.
 #if ISOLATION_LEVEL == SERIALIZABLE
 	if (rc == RCOK) {
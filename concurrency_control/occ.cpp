@@ -5,6 +5,7 @@
 #include "manager.h"
 #include "mem_alloc.h"
 #include "row_occ.h"
+#include "thread.h"
 
 
 set_ent::set_ent() {
@@ -73,7 +74,7 @@ OptCC::per_row_validate(txn_man * txn) {
 	if (ok) {
 		// Validation passed.
 		// advance the global timestamp and get the end_ts
-		txn->end_ts = glob_manager->get_ts( txn->get_thd_id() );
+		txn->end_ts = txn->h_thd->get_commit_ts();
 		// write to each row and update wts
 		txn->cleanup(RCOK);
 		rc = RCOK;
@@ -16,10 +16,10 @@ void Row_hekaton::init(row_t * row) {
 	for (uint32_t i = 0; i < _his_len; i++)
 		_write_history[i].row = NULL;
 	_write_history[0].row = row;
-	_write_history[0].begin_txn = false;
-	_write_history[0].end_txn = false;
 	_write_history[0].begin = 0;
 	_write_history[0].end = INF;
+	_latest_begin = 0;
+	_latest_row = row;
 
 	_his_latest = 0;
 	_his_oldest = 0;
@@ -37,8 +37,6 @@ Row_hekaton::doubleHistory()
 		temp[i] = _write_history[idx];
 		idx = (idx + 1) % _his_len;
 		temp[i + _his_len].row = NULL;
-		temp[i + _his_len].begin_txn = false;
-		temp[i + _his_len].end_txn = false;
 	}
 
 	_his_oldest = 0;
@@ -54,18 +52,17 @@ RC Row_hekaton::access(txn_man * txn, TsType type, row_t * row) {
 	ts_t ts = txn->get_ts();
 	while (!ATOM_CAS(blatch, false, true))
 		PAUSE
-	assert(_write_history[_his_latest].end == INF || _write_history[_his_latest].end_txn);
 	if (type == R_REQ) {
 		if (ISOLATION_LEVEL == REPEATABLE_READ) {
 			rc = RCOK;
-			txn->cur_row = _write_history[_his_latest].row;
-		} else if (ts < _write_history[_his_oldest].begin) {
-			rc = Abort;
-		} else if (ts > _write_history[_his_latest].begin) {
+			txn->cur_row = _latest_row;
+		} else if (ts > _latest_begin) {
 			// TODO. should check the next history entry. If that entry is locked by a preparing txn,
 			// may create a commit dependency. For now, I always return non-speculative entries.
 			rc = RCOK;
-			txn->cur_row = _write_history[_his_latest].row;
+			txn->cur_row = _latest_row;
+		} else if (ts < _write_history[_his_oldest].begin) {
+			rc = Abort;
 		} else {
 			rc = RCOK;
 			// ts is between _oldest_wts and _latest_wts, should find the correct version
@@ -85,20 +82,20 @@ RC Row_hekaton::access(txn_man * txn, TsType type, row_t * row) {
 			assert(find);
 		}
 	} else if (type == P_REQ) {
-		if (_exists_prewrite || ts < _write_history[_his_latest].begin) {
+		if (_exists_prewrite || ts < _latest_begin) {
 			rc = Abort;
 		} else {
 			rc = RCOK;
+			assert(_write_history[_his_latest].end == INF);
 			_exists_prewrite = true;
 			uint32_t id = reserveRow(txn);
 			uint32_t pre_id = (id == 0)? _his_len - 1 : id - 1;
-			_write_history[id].begin_txn = true;
-			_write_history[id].begin = txn->get_txn_id();
-			_write_history[pre_id].end_txn = true;
-			_write_history[pre_id].end = txn->get_txn_id();
+			ts_t txn_tag = txn->get_txn_id() | HEKATON_TXN_BIT;
+			_write_history[id].begin = txn_tag;
+			_write_history[pre_id].end = txn_tag;
 			row_t * res_row = _write_history[id].row;
 			assert(res_row);
-			res_row->copy(_write_history[_his_latest].row);
+			res_row->copy(_latest_row);
 			txn->cur_row = res_row;
 		}
 	} else
@@ -154,15 +151,22 @@ Row_hekaton::prepare_read(txn_man * txn, row_t * row, ts_t commit_ts)
 	RC rc;
 	while (!ATOM_CAS(blatch, false, true))
 		PAUSE
+	// the latest version ends at INF or at a preparing txn, which we simply
+	// commit after.
+	if (row == _latest_row) {
+		rc = (txn->get_ts() < _latest_begin)? Abort : RCOK;
+		blatch = false;
+		return rc;
+	}
 	// TODO may pass in a pointer to the history entry to reduce the following scan overhead.
 	uint32_t idx = _his_latest;
 	while (true) {
 		if (_write_history[idx].row == row) {
 			if (txn->get_ts() < _write_history[idx].begin) {
 				rc = Abort;
-			} else if (!_write_history[idx].end_txn && _write_history[idx].end > commit_ts)
+			} else if (!is_txn(_write_history[idx].end) && _write_history[idx].end > commit_ts)
 				rc = RCOK;
-			else if (!_write_history[idx].end_txn && _write_history[idx].end < commit_ts) {
+			else if (!is_txn(_write_history[idx].end) && _write_history[idx].end < commit_ts) {
 				rc = Abort;
 			} else {
 				// TODO. if the end is a txn id, should check that status of that txn.
@@ -188,16 +192,17 @@ Row_hekaton::post_process(txn_man * txn, ts_t commit_ts, RC rc)
 		PAUSE
 
 	WriteHisEntry * entry = &_write_history[ (_his_latest + 1) % _his_len ];
-	assert(entry->begin_txn && entry->begin == txn->get_txn_id());
-	_write_history[ _his_latest ].end_txn = false;
+	assert(entry->begin == (txn->get_txn_id() | HEKATON_TXN_BIT));
 	_exists_prewrite = false;
 	if (rc == RCOK) {
-		assert(commit_ts > _write_history[_his_latest].begin);
+		assert(commit_ts > _latest_begin);
 		_write_history[ _his_latest ].end = commit_ts;
 		entry->begin = commit_ts;
 		entry->end = INF;
 		_his_latest = (_his_latest + 1) % _his_len;
 		assert(_his_latest != _his_oldest);
+		_latest_begin = commit_ts;
+		_latest_row = entry->row;
 	} else
 		_write_history[ _his_latest ].end = INF;
 
@@ -225,6 +230,7 @@ Row_hekaton::set_ts(ts_t commit_ts)
   assert(_his_latest == 0);
 
   _write_history[0].begin = commit_ts;
+  _latest_begin = commit_ts;
 
 	blatch = false;
 }
@@ -11,15 +11,16 @@ class txn_man;
 
 #if CC_ALG == HEKATON
 
+// begin/end hold either a commit timestamp or, while a txn is writing the
+// version, that txn's id tagged with HEKATON_TXN_BIT.
 struct WriteHisEntry {
-	bool begin_txn;	
-	bool end_txn;
 	ts_t begin;
 	ts_t end;
 	row_t * row;
 };
 
-#define INF UINT64_MAX
+#define HEKATON_TXN_BIT (1UL << 63)
+#define INF (HEKATON_TXN_BIT - 1)
 
 class Row_hekaton {
 public:
@@ -33,16 +34,21 @@ public:
   void      set_ts(ts_t commit_ts);
 
 private:
-	volatile bool 	blatch;
+	static bool 	is_txn(ts_t v) { return v & HEKATON_TXN_BIT; }
 	uint32_t 		reserveRow(txn_man * txn);
 	void 			doubleHistory();
 
+	// the latest committed version is kept inline so most reads never touch
+	// _write_history. Older versions live in the circular buffer.
+	volatile bool 	blatch;
+	bool  			_exists_prewrite;
+	ts_t 			_latest_begin;
+	row_t * 		_latest_row;
+
 	uint32_t 		_his_latest;
 	uint32_t 		_his_oldest;
-	WriteHisEntry * _write_history; // circular buffer
-	bool  			_exists_prewrite;
-	
 	uint32_t 		_his_len;
+	WriteHisEntry * _write_history; // circular buffer
 };
 
 #endif
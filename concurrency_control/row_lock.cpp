@@ -11,12 +11,14 @@ void Row_lock::init(row_t * row) {
 	waiters_tail = NULL;
 	owner_cnt = 0;
 	waiter_cnt = 0;
+#if BAMBOO
+	retired_head = NULL;
+	retired_tail = NULL;
+	aborting_cnt = 0;
+#endif
 
-	latch = new pthread_mutex_t;
-	pthread_mutex_init(latch, NULL);
-	
+	latch = false;
 	lock_type = LOCK_NONE;
-	blatch = false;
 
 }
 
@@ -29,11 +31,7 @@ RC Row_lock::lock_get(lock_t type, txn_man * txn) {
 RC Row_lock::lock_get(lock_t type, txn_man * txn, uint64_t* &txnids, int &txncnt) {
 	assert (CC_ALG == DL_DETECT || CC_ALG == NO_WAIT || CC_ALG == WAIT_DIE);
 	RC rc;
-	int part_id =_row->get_part_id();
-	if (g_central_man)
-		glob_manager->lock_row(_row);
-	else 
-		pthread_mutex_lock( latch );
+	get_latch();
 	assert(owner_cnt <= g_thread_cnt);
 	assert(waiter_cnt < g_thread_cnt);
 #if DEBUG_ASSERT
@@ -66,6 +64,14 @@ RC Row_lock::lock_get(lock_t type, txn_man * txn, uint64_t* &txnids, int &txncnt
 	// Some txns coming earlier is waiting. Should also wait.
 	if (CC_ALG == DL_DETECT && waiters_head != NULL)
 		conflict = true;
+#if BAMBOO
+	// Commit dependencies must go from younger to older txns.
+	// Otherwise, two txns could wait for each other to commit.
+	if (txn->bb_abort || !can_depend(txn)) {
+		rc = Abort;
+		goto final;
+	}
+#endif
 	
 	if (conflict) { 
 		// Cannot be added to the owner list.
@@ -73,12 +79,13 @@ RC Row_lock::lock_get(lock_t type, txn_man * txn, uint64_t* &txnids, int &txncnt
 			rc = Abort;
 			goto final;
 		} else if (CC_ALG == DL_DETECT) {
-			LockEntry * entry = get_entry();
+			LockEntry * entry = get_entry(txn);
 			entry->txn = txn;
 			entry->type = type;
 			LIST_PUT_TAIL(waiters_head, waiters_tail, entry);
 			waiter_cnt ++;
-            txn->lock_ready = false;
+			entry->ready = false;
+			txn->wait_entry = entry;
             rc = WAIT;
 		} else if (CC_ALG == WAIT_DIE) {
             ///////////////////////////////////////////////////////////
@@ -101,7 +108,7 @@ RC Row_lock::lock_get(lock_t type, txn_man * txn, uint64_t* &txnids, int &txncnt
 			if (canwait) {
 				// insert txn to the right position
 				// the waiter list is always in timestamp order
-				LockEntry * entry = get_entry();
+				LockEntry * entry = get_entry(txn);
 				entry->txn = txn;
 				entry->type = type;
 				en = waiters_head;
@@ -114,19 +121,23 @@ RC Row_lock::lock_get(lock_t type, txn_man * txn, uint64_t* &txnids, int &txncnt
 				} else 
 					LIST_PUT_TAIL(waiters_head, waiters_tail, entry);
 				waiter_cnt ++;
-                txn->lock_ready = false;
+				entry->ready = false;
+				txn->wait_entry = entry;
                 rc = WAIT;
             }
             else 
                 rc = Abort;
         }
 	} else {
-		LockEntry * entry = get_entry();
+		LockEntry * entry = get_entry(txn);
 		entry->type = type;
 		entry->txn = txn;
 		STACK_PUSH(owners, entry);
 		owner_cnt ++;
 		lock_type = type;
+#if BAMBOO
+		add_dep(entry);
+#endif
 		if (CC_ALG == DL_DETECT) 
 			ASSERT(waiters_head == NULL);
         rc = RCOK;
@@ -136,7 +147,8 @@ final:
 	if (rc == WAIT && CC_ALG == DL_DETECT) {
 		// Update the waits-for graph
 		ASSERT(waiters_tail->txn == txn);
-		txnids = (uint64_t *) mem_allocator.alloc(sizeof(uint64_t) * (owner_cnt + waiter_cnt), part_id);
+		// the buffer is owned by the waiting thread and reused across waits.
+		txnids = dl_detector.get_edge_buf(txn->get_thd_id());
 		txncnt = 0;
 		LockEntry * en = waiters_tail->prev;
 		while (en != NULL) {
@@ -153,21 +165,18 @@ final:
 		ASSERT(txncnt > 0);
 	}
 
-	if (g_central_man)
-		glob_manager->release_row(_row);
-	else
-		pthread_mutex_unlock( latch );
+	release_latch();
 
 	return rc;
 }
 
 
 RC Row_lock::lock_release(txn_man * txn) {	
+#if BAMBOO
+	return lock_release(txn, false, NULL);
+#else
 
-	if (g_central_man)
-		glob_manager->lock_row(_row);
-	else 
-		pthread_mutex_lock( latch );
+	get_latch();
 
 	// Try to find the entry in the owners
 	LockEntry * en = owners;
@@ -206,25 +215,169 @@ RC Row_lock::lock_release(txn_man * txn) {
 			assert(en->next->txn->get_ts() < en->txn->get_ts());
 #endif
 
+	promote_waiters();
+
+	release_latch();
+
+	return RCOK;
+#endif
+}
+
+#if BAMBOO
+void Row_lock::lock_retire(txn_man * txn) {
+	get_latch();
+
+	LockEntry * en = owners;
+	LockEntry * prev = NULL;
+	while (en != NULL && en->txn != txn) {
+		prev = en;
+		en = en->next;
+	}
+	// Only exclusive locks are retired. A txn doomed by a cascading abort
+	// keeps its lock so that no more txns depend on it.
+	if (en && en->type == LOCK_EX && !txn->bb_abort) {
+		if (prev) prev->next = en->next;
+		else owners = en->next;
+		owner_cnt --;
+		if (owner_cnt == 0)
+			lock_type = LOCK_NONE;
+		// en keeps has_dep. It depends on the same retired entries as before.
+		LIST_PUT_TAIL(retired_head, retired_tail, en);
+		INC_STATS(txn->get_thd_id(), bb_retire_cnt, 1);
+		promote_waiters();
+	}
+
+	release_latch();
+}
+
+RC Row_lock::lock_release(txn_man * txn, bool abort, row_t * orig) {
+	get_latch();
+
+	LockEntry * en = owners;
+	LockEntry * prev = NULL;
+	while (en != NULL && en->txn != txn) {
+		prev = en;
+		en = en->next;
+	}
+	if (en) { // find the entry in the owner list
+		// an owner never has txns depending on it.
+		if (orig)
+			_row->copy(orig);
+		if (prev) prev->next = en->next;
+		else owners = en->next;
+		return_entry(en);
+		owner_cnt --;
+		if (owner_cnt == 0)
+			lock_type = LOCK_NONE;
+	} else {
+		en = retired_head;
+		while (en != NULL && en->txn != txn)
+			en = en->next;
+		if (en && !abort) {
+			// all the txns ahead have committed. Otherwise txn could not commit.
+			ASSERT(en == retired_head);
+			LIST_GET_HEAD(retired_head, retired_tail, en);
+			return_entry(en);
+			resolve_deps();
+		} else if (en) {
+			// Cascading abort. Every txn behind en has seen its dirty data.
+			en->aborting = true;
+			aborting_cnt ++;
+			for (LockEntry * dep = en->next; dep != NULL; dep = dep->next)
+				dep->txn->bb_abort = true;
+			for (LockEntry * dep = owners; dep != NULL; dep = dep->next)
+				dep->txn->bb_abort = true;
+			// The dependents roll back first (youngest first) so that en
+			// restores the last before-image.
+			while (en->next != NULL || owners != NULL) {
+				release_latch();
+				PAUSE
+				get_latch();
+			}
+			if (orig)
+				_row->copy(orig);
+			LIST_REMOVE_HT(en, retired_head, retired_tail);
+			return_entry(en);
+			aborting_cnt --;
+		} else {
+			// Not in owners or retired list, try waiters list.
+			en = waiters_head;
+			while (en != NULL && en->txn != txn)
+				en = en->next;
+			ASSERT(en);
+			LIST_REMOVE(en);
+			if (en == waiters_head)
+				waiters_head = en->next;
+			if (en == waiters_tail)
+				waiters_tail = en->prev;
+			return_entry(en);
+			waiter_cnt --;
+		}
+	}
+
+	if (owner_cnt == 0)
+		ASSERT(lock_type == LOCK_NONE);
+
+	promote_waiters();
+
+	release_latch();
+
+	return RCOK;
+}
+
+bool Row_lock::can_depend(txn_man * txn) {
+	// retired_tail is the youngest retired txn.
+	return aborting_cnt == 0
+		&& (retired_tail == NULL || retired_tail->txn->get_ts() < txn->get_ts());
+}
+
+void Row_lock::add_dep(LockEntry * entry) {
+	entry->aborting = false;
+	entry->has_dep = (retired_head != NULL);
+	if (entry->has_dep) {
+		ATOM_ADD(entry->txn->commit_semaphore, 1);
+		INC_STATS(entry->txn->get_thd_id(), bb_dep_cnt, 1);
+	}
+}
+
+void Row_lock::resolve_deps() {
+	// The retired head and, if nothing is retired, all owners no longer
+	// depend on any txn on this row.
+	if (retired_head) {
+		if (retired_head->has_dep) {
+			retired_head->has_dep = false;
+			ATOM_SUB(retired_head->txn->commit_semaphore, 1);
+		}
+	} else {
+		for (LockEntry * en = owners; en != NULL; en = en->next)
+			if (en->has_dep) {
+				en->has_dep = false;
+				ATOM_SUB(en->txn->commit_semaphore, 1);
+			}
+	}
+}
+#endif
+
+void Row_lock::promote_waiters() {
 	LockEntry * entry;
 	// If any waiter can join the owners, just do it!
-	while (waiters_head && !conflict_lock(lock_type, waiters_head->type)) {
+	while (waiters_head && !conflict_lock(lock_type, waiters_head->type)
+#if BAMBOO
+			&& can_depend(waiters_head->txn)
+#endif
+			) {
 		LIST_GET_HEAD(waiters_head, waiters_tail, entry);
 		STACK_PUSH(owners, entry);
 		owner_cnt ++;
 		waiter_cnt --;
-		ASSERT(entry->txn->lock_ready == false);
-		entry->txn->lock_ready = true;
+#if BAMBOO
+		add_dep(entry);
+#endif
+		ASSERT(entry->ready == false);
+		entry->ready = true;
 		lock_type = entry->type;
 	} 
 	ASSERT((owners == NULL) == (owner_cnt == 0));
-
-	if (g_central_man)
-		glob_manager->release_row(_row);
-	else
-		pthread_mutex_unlock( latch );
-
-	return RCOK;
 }
 
 bool Row_lock::conflict_lock(lock_t l1, lock_t l2) {
@@ -236,12 +389,34 @@ bool Row_lock::conflict_lock(lock_t l1, lock_t l2) {
 		return false;
 }
 
-LockEntry * Row_lock::get_entry() {
-	LockEntry * entry = (LockEntry *) 
-		mem_allocator.alloc(sizeof(LockEntry), _row->get_part_id());
+void Row_lock::get_latch() {
+	if (g_central_man) {
+		glob_manager->lock_row(_row);
+		return;
+	}
+	while (latch || !ATOM_CAS(latch, false, true))
+		PAUSE
+}
+
+void Row_lock::release_latch() {
+	if (g_central_man) {
+		glob_manager->release_row(_row);
+		return;
+	}
+	COMPILER_BARRIER
+	latch = false;
+}
+
+// Entries come from the per-txn pool. An entry is always returned by the
+// thread of its txn, so the pool needs no synchronization.
+LockEntry * Row_lock::get_entry(txn_man * txn) {
+	LockEntry * entry;
+	STACK_POP(txn->free_lock_entries, entry);
+	assert(entry != NULL);
 	return entry;
 }
 void Row_lock::return_entry(LockEntry * entry) {
-	mem_allocator.free(entry, sizeof(LockEntry));
+	txn_man * txn = entry->txn;
+	STACK_PUSH(txn->free_lock_entries, entry);
 }
 
@@ -3,12 +3,25 @@
 
 class txn_man;
 
+#if BAMBOO && CC_ALG != NO_WAIT && CC_ALG != WAIT_DIE
+#error "BAMBOO is only supported by NO_WAIT and WAIT_DIE"
+#endif
+
 struct LockEntry {
     lock_t type;
     txn_man * txn;
 	LockEntry * next;
 	LockEntry * prev;
-};
+	// set when the lock is granted. A waiter spins only on its own entry.
+	bool volatile ready;
+#if BAMBOO
+	// the txn joined while retired entries were present and is counted in
+	// txn->commit_semaphore until all retired entries ahead of it commit.
+	bool has_dep;
+	// the (retired) txn is aborting and waits for its dependents to leave.
+	bool aborting;
+#endif
+} __attribute__((aligned(CL_SIZE)));
 
 class Row_lock {
 public:
@@ -17,14 +30,29 @@ public:
     RC lock_get(lock_t type, txn_man * txn);
     RC lock_get(lock_t type, txn_man * txn, uint64_t* &txnids, int &txncnt);
     RC lock_release(txn_man * txn);
+#if BAMBOO
+	// [BAMBOO] move txn's exclusive lock from owners to retired after its
+	// last write. Later txns may access the dirty data with a commit
+	// dependency. orig is the before-image restored if the txn aborts.
+	void lock_retire(txn_man * txn);
+    RC lock_release(txn_man * txn, bool abort, row_t * orig);
+#endif
 
 private:
-    pthread_mutex_t * latch;
-	bool blatch;
+	// test-and-test-and-set latch protecting the lists below.
+	volatile bool latch;
 
+	void 		get_latch();
+	void 		release_latch();
 	bool 		conflict_lock(lock_t l1, lock_t l2);
-	LockEntry * get_entry();
+	LockEntry * get_entry(txn_man * txn);
 	void 		return_entry(LockEntry * entry);
+	void 		promote_waiters();
+#if BAMBOO
+	bool 		can_depend(txn_man * txn);
+	void 		add_dep(LockEntry * entry);
+	void 		resolve_deps();
+#endif
 	row_t * _row;
     lock_t lock_type;
     UInt32 owner_cnt;
@@ -37,6 +65,14 @@ private:
 	LockEntry * owners;
 	LockEntry * waiters_head;
 	LockEntry * waiters_tail;
+#if BAMBOO
+	// retired is a double linked list in retiring order.
+	// [retired] head is the oldest txn; every later entry and every owner
+	//   depends on the entries ahead of it.
+	LockEntry * retired_head;
+	LockEntry * retired_tail;
+	UInt32 aborting_cnt;
+#endif
 };
 
 #endif
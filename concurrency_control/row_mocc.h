@@ -0,0 +1,37 @@
+#pragma once
+
+#include "global.h"
+#include "helper.h"
+
+#if MOCC
+
+// Per-row temperature for the MOCC-style hybrid mode of SILO and TICTOC.
+// The temperature is bumped whenever the row causes a validation failure and
+// is halved for every MOCC_DECAY_PERIOD that passed since the last bump.
+// A row is hot once its temperature reaches MOCC_HOT_THRESHOLD; writes to hot
+// rows lock the row at access time instead of at validation time.
+// Updates are not atomic. Losing an increment under a race is harmless.
+class Row_temp {
+public:
+	void 				init() { _temp = 0; _period = 0; }
+	bool 				is_hot() { return _temp != 0 && get() >= MOCC_HOT_THRESHOLD; }
+	uint32_t 			get() {
+		uint32_t temp = _temp;
+		uint32_t elapsed = cur_period() - _period;
+		return elapsed >= 32 ? 0 : temp >> elapsed;
+	}
+	void 				heat() {
+		uint32_t temp = get();
+		_period = cur_period();
+		if (temp < MOCC_MAX_TEMP)
+			temp ++;
+		_temp = temp;
+	}
+private:
+	static uint32_t 	cur_period() { return (uint32_t)(get_server_clock() / MOCC_DECAY_PERIOD); }
+
+	volatile uint32_t 	_temp;
+	volatile uint32_t 	_period;
+};
+
+#endif
@@ -44,7 +44,11 @@ Row_occ::validate(uint64_t ts) {
 
 void
 Row_occ::write(row_t * data, uint64_t ts) {
+#if DELTA_WRITE
+	_row->apply_delta(data);
+#else
 	_row->copy(data);
+#endif
 	if (PER_ROW_VALID) {
 		assert(ts > wts);
 		wts = ts;
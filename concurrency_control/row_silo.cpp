@@ -16,16 +16,29 @@ Row_silo::init(row_t * row)
 	pthread_mutex_init( _latch, NULL );
 	_tid = 0;
 #endif
+#if MOCC
+	_temp.init();
+#endif
 }
 
 RC
 Row_silo::access(txn_man * txn, TsType type, row_t * local_row) {
+#if MOCC
+	txn->last_locked = false;
+	if (type == P_REQ && _temp.is_hot())
+		return access_hot(txn, local_row);
+#endif
 #if ATOMIC_WORD
 	uint64_t v = 0;
 	uint64_t v2 = 1;
 	while (v2 != v) {
 		v = _tid_word;
 		while (v & LOCK_BIT) {
+#if MOCC
+			// a txn holding hot locks never waits, so that it cannot deadlock.
+			if (txn->mocc_lock_cnt > 0)
+				return Abort;
+#endif
 			PAUSE
 			v = _tid_word;
 		}
@@ -35,6 +48,12 @@ Row_silo::access(txn_man * txn, TsType type, row_t * local_row) {
 	}
 	txn->last_tid = v & (~LOCK_BIT);
 #else
+#if MOCC
+	if (txn->mocc_lock_cnt > 0) {
+		if (!try_lock())
+			return Abort;
+	} else
+#endif
 	lock();
 	local_row->copy(_row);
 	txn->last_tid = _tid;
@@ -43,6 +62,27 @@ Row_silo::access(txn_man * txn, TsType type, row_t * local_row) {
 	return RCOK;
 }
 
+#if MOCC
+RC
+Row_silo::access_hot(txn_man * txn, row_t * local_row) {
+	// A txn that holds no hot locks cannot be part of a cycle, so it may wait.
+	if (txn->mocc_lock_cnt > 0) {
+		if (!try_lock())
+			return Abort;
+	} else
+		lock();
+	local_row->copy(_row);
+#if ATOMIC_WORD
+	txn->last_tid = _tid_word & (~LOCK_BIT);
+#else
+	txn->last_tid = _tid;
+#endif
+	txn->last_locked = true;
+	txn->mocc_lock_cnt ++;
+	return RCOK;
+}
+#endif
+
 bool
 Row_silo::validate(ts_t tid, bool in_write_set) {
 #if ATOMIC_WORD
@@ -69,7 +109,11 @@ Row_silo::validate(ts_t tid, bool in_write_set) {
 
 void
 Row_silo::write(row_t * data, uint64_t tid) {
+#if DELTA_WRITE
+	_row->apply_delta(data);
+#else
 	_row->copy(data);
+#endif
 #if ATOMIC_WORD
 	uint64_t v = _tid_word;
 	M_ASSERT(tid > (v & (~LOCK_BIT)) && (v & LOCK_BIT), "tid=%ld, v & LOCK_BIT=%ld, v & (~LOCK_BIT)=%ld\n", tid, (v & LOCK_BIT), (v & (~LOCK_BIT)));
@@ -1,5 +1,7 @@
 #pragma once 
 
+#include "row_mocc.h"
+
 class table_t;
 class Catalog;
 class txn_man;
@@ -24,7 +26,14 @@ public:
 	uint64_t 			get_tid();
 
 	void 				assert_lock() {assert(_tid_word & LOCK_BIT); }
+#if MOCC
+	void 				heat() { _temp.heat(); }
+#endif
 private:
+#if MOCC
+	RC 					access_hot(txn_man * txn, row_t * local_row);
+	Row_temp 			_temp;
+#endif
 #if ATOMIC_WORD
 	volatile uint64_t	_tid_word;
 #else
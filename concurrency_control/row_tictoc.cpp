@@ -21,11 +21,19 @@ Row_tictoc::init(row_t * row)
 #if TICTOC_MV
 	_hist_wts = 0;
 #endif
+#if MOCC
+	_temp.init();
+#endif
 }
 
 RC
 Row_tictoc::access(txn_man * txn, TsType type, row_t * local_row)
 {
+#if MOCC
+	txn->last_locked = false;
+	if (type == P_REQ && _temp.is_hot())
+		return access_hot(txn, local_row);
+#endif
 #if ATOMIC_WORD
 	uint64_t v = 0;
 	uint64_t v2 = 1;
@@ -36,6 +44,11 @@ Row_tictoc::access(txn_man * txn, TsType type, row_t * local_row)
 	while ((v2 | RTS_MASK) != (v | RTS_MASK)) {
 		v = _ts_word;
 		while (v & lock_mask) {
+#if MOCC
+			// a txn holding hot locks never waits, so that it cannot deadlock.
+			if (txn->mocc_lock_cnt > 0)
+				return Abort;
+#endif
 			PAUSE
 			v = _ts_word;
 		}
@@ -52,6 +65,12 @@ Row_tictoc::access(txn_man * txn, TsType type, row_t * local_row)
 	txn->last_wts = v & WTS_MASK;
 	txn->last_rts = ((v & RTS_MASK) >> WTS_LEN) + txn->last_wts;
 #else
+#if MOCC
+	if (txn->mocc_lock_cnt > 0) {
+		if (!try_lock())
+			return Abort;
+	} else
+#endif
 	lock();
 	txn->last_wts = _wts;
 	txn->last_rts = _rts;
@@ -61,6 +80,31 @@ Row_tictoc::access(txn_man * txn, TsType type, row_t * local_row)
 	return RCOK;
 }
 
+#if MOCC
+RC
+Row_tictoc::access_hot(txn_man * txn, row_t * local_row)
+{
+	// A txn that holds no hot locks cannot be part of a cycle, so it may wait.
+	if (txn->mocc_lock_cnt > 0) {
+		if (!try_lock())
+			return Abort;
+	} else
+		lock();
+#if ATOMIC_WORD
+	uint64_t v = _ts_word;
+	txn->last_wts = v & WTS_MASK;
+	txn->last_rts = ((v & RTS_MASK) >> WTS_LEN) + txn->last_wts;
+#else
+	txn->last_wts = _wts;
+	txn->last_rts = _rts;
+#endif
+	local_row->copy(_row);
+	txn->last_locked = true;
+	txn->mocc_lock_cnt ++;
+	return RCOK;
+}
+#endif
+
 void
 Row_tictoc::write_data(row_t * data, ts_t wts)
 {
@@ -75,7 +119,11 @@ Row_tictoc::write_data(row_t * data, ts_t wts)
   	v &= ~(RTS_MASK | WTS_MASK); // clear wts and rts.
 	v |= wts;
 	_ts_word = v;
+#if DELTA_WRITE
+	_row->apply_delta(data);
+#else
 	_row->copy(data);
+#endif
   #if WRITE_PERMISSION_LOCK
 	_ts_word &= (~LOCK_BIT);
   #endif
@@ -85,8 +133,12 @@ Row_tictoc::write_data(row_t * data, ts_t wts)
   #endif
 	_wts = wts;
 	_rts = wts;
+#if DELTA_WRITE
+	_row->apply_delta(data);
+#else
 	_row->copy(data);
 #endif
+#endif
 }
 
 bool
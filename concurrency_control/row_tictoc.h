@@ -1,6 +1,7 @@
 #pragma once 
 
 #include "global.h"
+#include "row_mocc.h"
 
 #if CC_ALG == TICTOC
 
@@ -48,8 +49,15 @@ public:
 	ts_t 				get_wts();
 	ts_t 				get_rts();
 	void 				get_ts_word(bool &lock, uint64_t &rts, uint64_t &wts);
+#if MOCC
+	void 				heat() { _temp.heat(); }
+#endif
 private:
 	row_t * 			_row;
+#if MOCC
+	RC 					access_hot(txn_man * txn, row_t * local_row);
+	Row_temp 			_temp;
+#endif
 #if ATOMIC_WORD
 	volatile uint64_t	_ts_word; 
 #else
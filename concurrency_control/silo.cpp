@@ -40,10 +40,13 @@ txn_man::validate_silo()
 	int num_locks = 0;
 	ts_t max_tid = 0;
 	bool done = false;
+	// the row that caused the abort, if any. [MOCC] its temperature is bumped.
+	row_t * conflict_row = NULL;
 	if (_pre_abort) {
 		for (int i = 0; i < wr_cnt; i++) {
 			row_t * row = accesses[ write_set[i] ]->orig_row;
 			if (row->manager->get_tid() != accesses[write_set[i]]->tid) {
+				conflict_row = row;
 				rc = Abort;
 				goto final;
 			}
@@ -52,6 +55,7 @@ txn_man::validate_silo()
 		for (int i = 0; i < row_cnt - wr_cnt; i ++) {
 			Access * access = accesses[ read_set[i] ];
 			if (access->orig_row->manager->get_tid() != accesses[read_set[i]]->tid) {
+				conflict_row = access->orig_row;
 				rc = Abort;
 				goto final;
 			}
@@ -65,12 +69,23 @@ txn_man::validate_silo()
 			num_locks = 0;
 			for (int i = 0; i < wr_cnt; i++) {
 				row_t * row = accesses[ write_set[i] ]->orig_row;
+#if MOCC
+				if (mocc_lock_cnt > 0) {
+					// cannot retry while holding hot locks.
+					if (!accesses[ write_set[i] ]->locked && !row->manager->try_lock()) {
+						conflict_row = row;
+						rc = Abort;
+						goto final;
+					}
+				} else
+#endif
 				if (!row->manager->try_lock())
 					break;
 				row->manager->assert_lock();
 				num_locks ++;
 				if (row->manager->get_tid() != accesses[write_set[i]]->tid)
 				{
+					conflict_row = row;
 					rc = Abort;
 					goto final;
 				}
@@ -85,6 +100,7 @@ txn_man::validate_silo()
 					for (int i = 0; i < wr_cnt; i++) {
 						row_t * row = accesses[ write_set[i] ]->orig_row;
 						if (row->manager->get_tid() != accesses[write_set[i]]->tid) {
+							conflict_row = row;
 							rc = Abort;
 							goto final;
 						}
@@ -93,6 +109,7 @@ txn_man::validate_silo()
 					for (int i = 0; i < row_cnt - wr_cnt; i ++) {
 						Access * access = accesses[ read_set[i] ];
 						if (access->orig_row->manager->get_tid() != accesses[read_set[i]]->tid) {
+							conflict_row = access->orig_row;
 							rc = Abort;
 							goto final;
 						}
@@ -105,9 +122,20 @@ txn_man::validate_silo()
 	} else {
 		for (int i = 0; i < wr_cnt; i++) {
 			row_t * row = accesses[ write_set[i] ]->orig_row;
+#if MOCC
+			if (mocc_lock_cnt > 0) {
+				// cannot wait while holding hot locks.
+				if (!accesses[ write_set[i] ]->locked && !row->manager->try_lock()) {
+					conflict_row = row;
+					rc = Abort;
+					goto final;
+				}
+			} else
+#endif
 			row->manager->lock();
 			num_locks++;
 			if (row->manager->get_tid() != accesses[write_set[i]]->tid) {
+				conflict_row = row;
 				rc = Abort;
 				goto final;
 			}
@@ -121,6 +149,7 @@ txn_man::validate_silo()
 		Access * access = accesses[ read_set[i] ];
 		bool success = access->orig_row->manager->validate(access->tid, false);
 		if (!success) {
+			conflict_row = access->orig_row;
 			rc = Abort;
 			goto final;
 		}
@@ -133,6 +162,7 @@ txn_man::validate_silo()
 		Access * access = accesses[ write_set[i] ];
 		bool success = access->orig_row->manager->validate(access->tid, true);
 		if (!success) {
+			conflict_row = access->orig_row;
 			rc = Abort;
 			goto final;
 		}
@@ -144,9 +174,19 @@ txn_man::validate_silo()
 	else
 		_cur_tid ++;
 final:
+#if MOCC
+	if (conflict_row)
+		conflict_row->manager->heat();
+#else
+	(void)conflict_row;
+#endif
 	rc = apply_index_changes(rc);
 	if (rc == Abort) {
+		// [MOCC] hot locks are released in cleanup().
 		for (int i = 0; i < num_locks; i++)
+#if MOCC
+			if (!accesses[ write_set[i] ]->locked)
+#endif
 			accesses[ write_set[i] ]->orig_row->manager->release();
 		cleanup(rc);
 	} else {
@@ -159,6 +199,9 @@ final:
 			access->orig_row->manager->write(
 				access->data, _cur_tid );
 			accesses[ write_set[i] ]->orig_row->manager->release();
+#if MOCC
+			access->locked = false;
+#endif
 		}
 		cleanup(rc);
 	}
@@ -73,11 +73,14 @@ txn_man::validate_tictoc()
 #if WR_VALIDATION_SEPARATE
 	bool done = false;
 #endif
+	// the row that caused the abort, if any. [MOCC] its temperature is bumped.
+	row_t * conflict_row = NULL;
 	if (_pre_abort) {
 		for (int i = 0; i < wr_cnt; i++) {
 			row_t * row = accesses[ write_set[i] ]->orig_row;
 			if (row->manager->get_wts() != accesses[ write_set[i] ]->wts)
 			{
+				conflict_row = row;
 				rc = Abort;
 				goto final;
 			}
@@ -94,6 +97,7 @@ txn_man::validate_tictoc()
 			if (commit_wts > rts && (wts != accesses[ read_set[i] ]->wts))
 		#endif
 			{
+				conflict_row = row;
 				rc = Abort;
 				goto final;
 			}
@@ -107,11 +111,22 @@ txn_man::validate_tictoc()
 			num_locks = 0;
 			for (int i = 0; i < wr_cnt; i++) {
 				row_t * row = accesses[ write_set[i] ]->orig_row;
+#if MOCC
+				if (mocc_lock_cnt > 0) {
+					// cannot retry while holding hot locks.
+					if (!accesses[ write_set[i] ]->locked && !row->manager->try_lock()) {
+						conflict_row = row;
+						rc = Abort;
+						goto final;
+					}
+				} else
+#endif
 				if (!row->manager->try_lock())
 					break;
 				num_locks ++;
 				if (row->manager->get_wts() != accesses[ write_set[i] ]->wts)
 				{
+					conflict_row = row;
 					rc = Abort;
 					goto final;
 				}
@@ -127,6 +142,7 @@ txn_man::validate_tictoc()
 						row_t * row = accesses[ write_set[i] ]->orig_row;
 						if (row->manager->get_wts() != accesses[ write_set[i] ]->wts)
 						{
+							conflict_row = row;
 							rc = Abort;
 							goto final;
 						}
@@ -143,6 +159,7 @@ txn_man::validate_tictoc()
 						if (wts != access->wts && commit_wts > rts)
 					#endif
 						{
+							conflict_row = access->orig_row;
 							rc = Abort;
 							goto final;
 						}
@@ -156,10 +173,21 @@ txn_man::validate_tictoc()
 	else { // _validation_no_wait = false
 		for (int i = 0; i < wr_cnt; i++) {
 			row_t * row = accesses[ write_set[i] ]->orig_row;
+#if MOCC
+			if (mocc_lock_cnt > 0) {
+				// cannot wait while holding hot locks.
+				if (!accesses[ write_set[i] ]->locked && !row->manager->try_lock()) {
+					conflict_row = row;
+					rc = Abort;
+					goto final;
+				}
+			} else
+#endif
 			row->manager->lock();
 			num_locks++;
 			if (row->manager->get_wts() != accesses[ write_set[i] ]->wts)
 			{
+				conflict_row = row;
 				rc = Abort;
 				goto final;
 			}
@@ -187,6 +215,7 @@ txn_man::validate_tictoc()
 			bool success = true;
     #endif
 			if (!success) {
+				conflict_row = access->orig_row;
 				rc = Abort;
 				goto final;
 			}
@@ -225,10 +254,20 @@ txn_man::validate_tictoc()
 */
 #endif
 final:
+#if MOCC
+	if (conflict_row)
+		conflict_row->manager->heat();
+#else
+	(void)conflict_row;
+#endif
 	rc = apply_index_changes(rc);
 	if (rc == Abort) {
 #if WR_VALIDATION_SEPARATE
+		// [MOCC] hot locks are released in cleanup().
 		for (int i = 0; i < num_locks; i++)
+#if MOCC
+			if (!accesses[ write_set[i] ]->locked)
+#endif
 			accesses[ write_set[i] ]->orig_row->manager->release();
 #else
 		for (int i = 0; i < num_locks; i++)
@@ -252,6 +291,9 @@ final:
 				access->orig_row->manager->write_data(
 					access->data, commit_wts);
 				access->orig_row->manager->release();
+#if MOCC
+				access->locked = false;
+#endif
 			}
 #else
 //			for (int i = 0; i < row_cnt; i++) {
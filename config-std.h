@@ -13,7 +13,7 @@
 
 // # of transactions to run for warmup
 #define WARMUP						0
-// YCSB or TPCC or TATP
+// YCSB or TPCC or TATP or SMALLBANK or CUSTOM
 #define WORKLOAD 					YCSB
 // print the transaction latency distribution
 #define PRT_LAT_DISTR				false
@@ -23,8 +23,11 @@
 #define MEM_ALLIGN					8
 
 // [THREAD_ALLOC]
+// per-thread size-class slabs with remote-free queues. mem_alloc::free()
+// finds the size class from the header of the MEM_SLAB_SIZE-aligned slab.
 #define THREAD_ALLOC				false
 #define THREAD_ARENA_SIZE			(1UL << 22)
+#define MEM_SLAB_SIZE				(1UL << 16)
 #define MEM_PAD 					true
 
 // [PART_ALLOC]
@@ -32,6 +35,39 @@
 #define MEM_SIZE					(1UL << 30)
 #define NO_FREE						false
 
+// [ROW_HEAP]
+// rows of each table partition are carved from extents of
+// ROW_HEAP_EXTENT_SIZE and addressed by row id. A freed slot is reused
+// once RCU says no txn can still read it. HEKATON and MVCC never free
+// deleted rows.
+#define ROW_HEAP					false
+#define ROW_HEAP_EXTENT_SIZE		(1UL << 21)
+
+// [COLD_STORE]
+// requires ROW_HEAP. Every COLD_COMPACT_INTVL committed txns, a thread
+// freezes rows of the tables that enabled it (partitions part_id %
+// g_thread_cnt == thd_id) into immutable dictionary-encoded blocks of
+// COLD_BLOCK_ROWS rows. The newest COLD_KEEP_ROWS row slots of a partition
+// are never frozen.
+#define COLD_STORE					false
+#define COLD_BLOCK_ROWS				256
+#define COLD_COMPACT_INTVL			10000
+#define COLD_KEEP_ROWS				10000
+
+// [COLUMN_GROUP]
+// lay out the columns of a row grouped by the column family given in the
+// schema file (4th field), each group starting on its own cache line, so a
+// txn touching the columns of one group reads one or two lines. Rows are
+// cache line aligned only with ROW_HEAP.
+#define COLUMN_GROUP				false
+
+// [HUGE_PAGE]
+// back index bucket arrays and row storage with huge pages of HUGE_PAGE_SIZE
+// (1UL << 21 or 1UL << 30). Falls back to transparent huge pages when no
+// huge pages are reserved.
+#define HUGE_PAGE					false
+#define HUGE_PAGE_SIZE				(1UL << 21)
+
 // [RCU_ALLOC]
 #define RCU_ALLOC 					false
 #define RCU_ALLOC_SIZE     (20 * 1073741824UL)	// 20 GB
@@ -66,11 +102,20 @@
 #define DL_LOOP_TRIAL				100	// 1 us
 #define NO_DL						KEY_ORDER
 #define TIMEOUT						1000000 // 1ms
+// [NO_WAIT, WAIT_DIE]
+// BAMBOO: a txn retires its exclusive lock after its last write to the row.
+// Later txns may access the dirty data and commit after the writer commits.
+#define BAMBOO						false
 // [TIMESTAMP]
 #define TS_TWR						false
 #define TS_ALLOC					TS_CAS
 #define TS_BATCH_ALLOC				false
 #define TS_BATCH_NUM				1
+// TS_CLOCK: loosely synchronized per-thread clocks. Every TS_CLOCK_SYNC_INTVL
+// allocations a thread moves its clock to within TS_CLOCK_SKEW (ns) of the
+// fastest thread.
+#define TS_CLOCK_SKEW				1000
+#define TS_CLOCK_SYNC_INTVL			1024
 // [MVCC]
 // when read/write history is longer than HIS_RECYCLE_LEN
 // the history should be recycled.
@@ -91,6 +136,17 @@
 #define VALIDATION_LOCK				"no-wait" // no-wait or waiting
 #define PRE_ABORT					"true"
 #define ATOMIC_WORD					true
+// [MOCC] (TICTOC, SILO) writes to hot rows lock the row at access time.
+// A row is hot when its temperature (validation failures it caused, halved
+// every MOCC_DECAY_PERIOD) reaches MOCC_HOT_THRESHOLD.
+#define MOCC						false
+#define MOCC_HOT_THRESHOLD			8
+#define MOCC_MAX_TEMP				1024
+#define MOCC_DECAY_PERIOD			1000000 // 1 ms. In nanoseconds
+// [DELTA_WRITE] (TICTOC, SILO, OCC) the local copy of a row tracks which
+// cache lines of its data were modified, and only those are written back
+// at commit.
+#define DELTA_WRITE					false
 // [HSTORE]
 // when set to true, hstore will not access the global timestamp.
 // This is fine for single partition transactions.
@@ -112,6 +168,20 @@
 #define MAX_ROW_PER_TXN				1024
 #define QUERY_INTVL 				1UL
 #define MAX_TXN_PER_PART 			100
+// [QUERY_STREAM]
+// generate each query right before it runs, into a per-thread pool of
+// ABORT_BUFFER_SIZE + 2 query objects, instead of pre-generating
+// WARMUP + MAX_TXN_PER_PART queries per thread before the run.
+#define QUERY_STREAM 				false
+// [QUERY_TRACE]
+// QUERY_TRACE_RECORD appends every new query handed to a thread to the
+// file <QUERY_TRACE_FILE>.<thd_id> (--trace_file=PATH overrides the path).
+// QUERY_TRACE_REPLAY takes the queries from those files instead of the
+// generator, so runs with different CC_ALGs get identical inputs. A trace
+// shorter than the run is replayed in a loop.
+#define QUERY_TRACE_RECORD			false
+#define QUERY_TRACE_REPLAY			false
+#define QUERY_TRACE_FILE			"query.trace"
 #define MAX_WARMUP_DURATION   10.0
 #define MAX_TXN_DURATION      30.0
 #define FIRST_PART_LOCAL 			true
@@ -128,6 +198,29 @@
 #define PERC_MULTI_PART				1
 #define REQ_PER_QUERY				16
 #define FIELD_PER_TUPLE				1
+// [YCSB_ORDERED_SCAN]
+// a SCAN request reads the keys [key, key + scan_len) of its partition
+// through ORDERED_MAIN_INDEX with index_read_range (YCSB-E). Phantoms are
+// caught by the index node validation (TPCC_VALIDATE_NODE).
+// With YCSB_SCAN_LEN_UNIFORM, scan_len is uniform in [1, SCAN_LEN].
+#define YCSB_ORDERED_SCAN			false
+#define YCSB_SCAN_LEN_UNIFORM		false
+// [YCSB_PHASE]
+// time-varying access patterns; they need QUERY_STREAM. The run is split
+// into phases of YCSB_PHASE_LEN ms (0: one phase), and commits and aborts
+// are reported per phase.
+// - the zipf ranks are rotated by YCSB_HOTSPOT_SHIFT keys every phase.
+// - with YCSB_LATEST, ranks count back from a newest key that advances by
+//   YCSB_LATEST_RATE keys per second (YCSB-D skew over a fixed table).
+// - every YCSB_BURST_INTVL-th phase (0: never) has YCSB_BURST_WRITE_PERC
+//   writes.
+#define YCSB_PHASE_LEN				0
+#define YCSB_MAX_PHASE				64
+#define YCSB_HOTSPOT_SHIFT			0
+#define YCSB_LATEST					false
+#define YCSB_LATEST_RATE			100000
+#define YCSB_BURST_INTVL			0
+#define YCSB_BURST_WRITE_PERC		0.9
 // ==== [TPCC] ====
 // For large warehouse count, the tables do not fit in memory
 // small tpcc schemas shrink the table size.
@@ -139,16 +232,22 @@
 #define WH_UPDATE					true
 #define NUM_WH 						1
 //
-#define TPCC_INSERT_ROWS  false
-#define TPCC_DELETE_ROWS  false
-#define TPCC_INSERT_INDEX false
-#define TPCC_DELETE_INDEX false
+// [TPCC_SPEC] spec-complete TPC-C: all five txns with their row and index
+// inserts/deletes, remote payment customers and 1% NewOrder rollbacks.
+#define TPCC_SPEC         false
+#define TPCC_INSERT_ROWS  TPCC_SPEC
+#define TPCC_DELETE_ROWS  TPCC_SPEC
+#define TPCC_INSERT_INDEX TPCC_SPEC
+#define TPCC_DELETE_INDEX TPCC_SPEC
 // TPCC_FULL requires TPCC_INSERT_ROWS and TPCC_UPDATE_INDEX to fully function
-#define TPCC_FULL         false
+#define TPCC_FULL         TPCC_SPEC
 #define TPCC_CF		  false
 #define TPCC_SPLIT_DELIVERY false
 #define TPCC_VALIDATE_GAP false
 #define TPCC_VALIDATE_NODE true
+// [TPCC_CHECK] verify the TPC-C consistency conditions after the run and
+// exit with an error on a violation.
+#define TPCC_CHECK        false
 #define SIMPLE_INDEX_UPDATE false
 //
 enum TPCCTxnType {TPCC_ALL,
@@ -158,6 +257,18 @@ enum TPCCTxnType {TPCC_ALL,
 				TPCC_DELIVERY,
 				TPCC_STOCK_LEVEL};
 extern TPCCTxnType 					g_tpcc_txn_type;
+// [CH_BENCH]
+// the last CH_OLAP_THREAD_CNT of the THREAD_CNT threads run CH-benCHmark
+// analytical queries in turn instead of the TPC-C mix. The queries scan
+// whole tables with table_scan (ROW_HEAP) and read each row through the
+// CC without keeping it in the txn: read committed under 2PL and
+// Silo/TicToc, a snapshot under HEKATON. HSTORE locks all partitions.
+#define CH_OLAP_THREAD_CNT			0
+enum CHQueryType {CH_Q1,
+				CH_Q6,
+				CH_Q11,
+				CH_Q14,
+				CH_QUERY_CNT};
 
 //#define TXN_TYPE					TPCC_ALL
 #define PERC_PAYMENT 				0.5
@@ -181,6 +292,30 @@ extern TPCCTxnType 					g_tpcc_txn_type;
 #define TATP_SCALE_FACTOR 1
 #define TATP_SUB_SIZE (TATP_DEFAULT_NUM_SUBSCRIBERS * TATP_SCALE_FACTOR)
 
+// ==== [SMALLBANK] ====
+#define SB_NUM_ACCOUNTS 1000000
+// SB_HOTSPOT_PERC % of the txns access the first SB_HOTSPOT_SIZE accounts.
+#define SB_HOTSPOT_SIZE 100
+#define SB_HOTSPOT_PERC 90
+#define SB_MIN_BALANCE 10000
+#define SB_MAX_BALANCE 50000
+#define SB_FREQUENCY_AMALGAMATE         15
+#define SB_FREQUENCY_BALANCE            15
+#define SB_FREQUENCY_DEPOSIT_CHECKING   15
+#define SB_FREQUENCY_SEND_PAYMENT       25
+#define SB_FREQUENCY_TRANSACT_SAVINGS   15
+#define SB_FREQUENCY_WRITE_CHECK        15
+
+// ==== [CUSTOM] ====
+// The tables, indexes and txn templates are read from CUSTOM_CONFIG_FILE
+// (--custom_config=PATH overrides the path). See benchmarks/CUSTOM_config.txt.
+#define CUSTOM_CONFIG_FILE				"./benchmarks/CUSTOM_config.txt"
+#define CUSTOM_MAX_TABLE				16
+#define CUSTOM_MAX_TXN					16
+#define CUSTOM_MAX_ACCESS				16
+// rows requested by a query; a scan counts once.
+#define CUSTOM_MAX_REQ					64
+
 /***********************************************/
 // TODO centralized CC management.
 /***********************************************/
@@ -225,6 +360,8 @@ extern TestCases					g_test_case;
 #define TPCC						2
 #define TATP						3
 #define TEST						4
+#define SMALLBANK					5
+#define CUSTOM						6
 // Concurrency Control Algorithm
 #define NO_WAIT						1
 #define WAIT_DIE					2
@@ -13,7 +13,7 @@ Catalog::init(const char * table_name, int field_cnt) {
 }
 
 void Catalog::add_col(char * col_name, uint64_t size, char * type, int cf_id) {
-#if !TPCC_CF
+#if !TPCC_CF && !COLUMN_GROUP
   assert(cf_id == 0);
 #endif
 
@@ -26,7 +26,7 @@ void Catalog::add_col(char * col_name, uint64_t size, char * type, int cf_id) {
 	strcpy(_columns[field_cnt].name, col_name);
 	_columns[field_cnt].id = field_cnt;
 	_columns[field_cnt].index = cf_sizes[cf_id];
-#if TPCC_CF
+#if TPCC_CF || COLUMN_GROUP
 	_columns[field_cnt].cf_id = cf_id;
 #endif
         cf_sizes[cf_id] += size;
@@ -34,6 +34,24 @@ void Catalog::add_col(char * col_name, uint64_t size, char * type, int cf_id) {
 	field_cnt ++;
 }
 
+void Catalog::finalize() {
+#if COLUMN_GROUP
+	// column groups are placed in cf_id order, each starting on a new cache
+	// line. get_field_index() then returns the offset in the whole tuple.
+	uint64_t cf_base[sizeof(cf_sizes) / sizeof(cf_sizes[0])];
+	uint64_t size = 0;
+	for (uint64_t cf_id = 0; cf_id < cf_count; cf_id ++) {
+		cf_base[cf_id] = size;
+		size += cf_sizes[cf_id];
+		if (cf_id + 1 < cf_count)
+			size = (size + CL_SIZE - 1) / CL_SIZE * CL_SIZE;
+	}
+	for (uint64_t i = 0; i < field_cnt; i++)
+		_columns[i].index += cf_base[_columns[i].cf_id];
+	tuple_size = size;
+#endif
+}
+
 uint64_t Catalog::get_field_id(const char * name) {
 	UInt32 i;
 	for (i = 0; i < field_cnt; i++) {
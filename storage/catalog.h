@@ -5,6 +5,10 @@
 #include "global.h"
 #include "helper.h"
 
+#if COLUMN_GROUP && TPCC_CF
+#error "COLUMN_GROUP and TPCC_CF are exclusive"
+#endif
+
 class Column {
 public:
 	Column() {
@@ -26,7 +30,7 @@ public:
 	UInt64 id;
 	UInt32 size;
 	UInt32 index;
-#if TPCC_CF
+#if TPCC_CF || COLUMN_GROUP
         uint64_t cf_id;
 #endif
 	char * type;
@@ -40,6 +44,8 @@ public:
 	// field_size is the size of each each field.
 	void init(const char * table_name, int field_cnt);
 	void add_col(char * col_name, uint64_t size, char * type, int cf_id);
+	// fix the column offsets once all the columns are added.
+	void finalize();
 
 	UInt32 			field_cnt;
  	const char * 	table_name;
@@ -49,7 +55,7 @@ public:
 	uint64_t 		get_field_cnt() { return field_cnt; };
 	uint64_t 		get_field_size(int id) { return _columns[id].size; };
 	uint64_t 		get_field_index(int id) { return _columns[id].index; };
-#if TPCC_CF
+#if TPCC_CF || COLUMN_GROUP
 	uint64_t 		get_field_cf_id(int id) { return _columns[id].cf_id; };
 #endif
 	char * 			get_field_type(uint64_t id);
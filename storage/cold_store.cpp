@@ -0,0 +1,260 @@
+#define CONFIG_H "silo/config/config-perf.h"
+#include "silo/rcu.h"
+#ifdef NDEBUG
+#undef NDEBUG
+#endif
+
+#include "cold_store.h"
+#include "table.h"
+#include "catalog.h"
+#include "row.h"
+#include "txn.h"
+#include "mem_alloc.h"
+#include "index_hash.h"
+#include "index_mbtree.h"
+
+#if COLD_STORE
+
+static_assert(COLD_BLOCK_ROWS <= (1 << 16), "the slot of a cold_ref has 16 bits");
+
+// builds the dictionary of a column over rows. Returns the # of distinct
+// values, or 0 if there are more than 256.
+static uint32_t
+build_dict(row_t ** rows, uint32_t row_cnt, uint32_t pos, uint32_t size,
+		char ** dict, uint8_t * codes)
+{
+	// open addressing on the FNV-1a hash of the value.
+	int16_t table[512];
+	memset(table, -1, sizeof(table));
+	uint32_t dict_cnt = 0;
+	for (uint32_t i = 0; i < row_cnt; i++) {
+		char * value = rows[i]->get_data() + pos;
+		uint64_t hash = 14695981039346656037UL;
+		for (uint32_t j = 0; j < size; j++)
+			hash = (hash ^ (uint8_t)value[j]) * 1099511628211UL;
+		uint32_t slot = hash % 512;
+		while (table[slot] != -1 && memcmp(dict[table[slot]], value, size) != 0)
+			slot = (slot + 1) % 512;
+		if (table[slot] == -1) {
+			if (dict_cnt == 256)
+				return 0;
+			table[slot] = dict_cnt;
+			dict[dict_cnt ++] = value;
+		}
+		codes[i] = table[slot];
+	}
+	return dict_cnt;
+}
+
+ColdBlock *
+ColdBlock::create(Catalog * schema, row_t ** rows, uint32_t row_cnt)
+{
+	assert(row_cnt > 0 && row_cnt <= COLD_BLOCK_ROWS);
+	uint32_t col_cnt = schema->get_field_cnt();
+	char * dict[256];
+	uint8_t codes[COLD_BLOCK_ROWS];
+
+	uint64_t size = sizeof(ColdBlock) + sizeof(Column) * col_cnt;
+	uint32_t dict_cnt[col_cnt];
+	for (uint32_t col = 0; col < col_cnt; col++) {
+		uint32_t pos = schema->get_field_index(col);
+		uint32_t col_size = schema->get_field_size(col);
+		dict_cnt[col] = build_dict(rows, row_cnt, pos, col_size, dict, codes);
+		size = (size + 7) / 8 * 8;
+		if (dict_cnt[col] > 0)
+			size += dict_cnt[col] * col_size + row_cnt;
+		else
+			size += row_cnt * col_size;
+	}
+
+	ColdBlock * block = (ColdBlock *) mem_allocator.alloc(size, -1);
+	block->table = rows[0]->get_table();
+	block->next = NULL;
+	block->state = PENDING;
+	block->size = size;
+	block->row_cnt = row_cnt;
+	block->col_cnt = col_cnt;
+	uint64_t payload = sizeof(ColdBlock) + sizeof(Column) * col_cnt;
+	for (uint32_t col = 0; col < col_cnt; col++) {
+		Column * c = block->get_col(col);
+		c->pos = schema->get_field_index(col);
+		c->size = schema->get_field_size(col);
+		c->dict_cnt = dict_cnt[col];
+		payload = (payload + 7) / 8 * 8;
+		c->payload = payload;
+		char * p = block->get_payload(c);
+		if (c->dict_cnt > 0) {
+			build_dict(rows, row_cnt, c->pos, c->size, dict, codes);
+			for (uint32_t i = 0; i < c->dict_cnt; i++)
+				memcpy(p + i * c->size, dict[i], c->size);
+			memcpy(p + c->dict_cnt * c->size, codes, row_cnt);
+			payload += c->dict_cnt * c->size + row_cnt;
+		} else {
+			for (uint32_t i = 0; i < row_cnt; i++)
+				memcpy(p + i * c->size, rows[i]->get_data() + c->pos, c->size);
+			payload += row_cnt * c->size;
+		}
+	}
+	assert(payload == size);
+	return block;
+}
+
+void
+ColdBlock::destroy()
+{
+	mem_allocator.free(this, size);
+}
+
+bool
+ColdBlock::wait_commit()
+{
+	while (state == PENDING)
+		PAUSE
+	return state == COMMITTED;
+}
+
+static void
+free_block(void * block)
+{
+	((ColdBlock *) block)->destroy();
+}
+
+void
+ColdBlock::decode(uint32_t slot, char * data)
+{
+	assert(slot < row_cnt);
+	for (uint32_t col = 0; col < col_cnt; col++) {
+		Column * c = get_col(col);
+		char * p = get_payload(c);
+		if (c->dict_cnt > 0) {
+			uint8_t code = p[c->dict_cnt * c->size + slot];
+			memcpy(data + c->pos, p + code * c->size, c->size);
+		} else
+			memcpy(data + c->pos, p + slot * c->size, c->size);
+	}
+}
+
+void
+ColdStore::init(table_t * table, filter_t filter)
+{
+	_table = table;
+	_filter = filter;
+	_index_cnt = 0;
+	uint64_t part_cnt = table->get_part_cnt();
+	_parts = (Part *) mem_allocator.alloc(sizeof(Part) * part_cnt, -1);
+	for (uint64_t part_id = 0; part_id < part_cnt; part_id++) {
+		_parts[part_id].latch = false;
+		_parts[part_id].frontier = 0;
+		_parts[part_id].blocks = NULL;
+	}
+}
+
+void
+ColdStore::add_index(ORDERED_INDEX * index, key_t key)
+{
+	assert(_index_cnt < MAX_COLD_INDEX);
+	_indexes[_index_cnt] = index;
+	_keys[_index_cnt] = key;
+	_index_cnt ++;
+}
+
+RC
+ColdStore::compact(txn_man * txn, uint64_t part_id)
+{
+	Part * part = &_parts[part_id];
+	if (part->latch || !ATOM_CAS(part->latch, false, true))
+		return RCOK;
+
+	uint64_t row_cnt = _table->get_row_cnt(part_id);
+	uint64_t end = (row_cnt > COLD_KEEP_ROWS)? row_cnt - COLD_KEEP_ROWS : 0;
+	// bound the work of a pass when the frontier is stuck at a hot row.
+	if (end > part->frontier + COLD_BLOCK_ROWS * 16)
+		end = part->frontier + COLD_BLOCK_ROWS * 16;
+
+	row_t * origs[COLD_BLOCK_ROWS];
+	row_t * rows[COLD_BLOCK_ROWS];
+	idx_key_t keys[COLD_BLOCK_ROWS][MAX_COLD_INDEX];
+	uint32_t cnt = 0;
+	uint64_t frontier = part->frontier;
+	bool stalled = false;
+	RC rc = RCOK;
+	for (uint64_t row_id = part->frontier; row_id < end && cnt < COLD_BLOCK_ROWS; row_id++) {
+		row_t * orig = _table->get_row(part_id, row_id);
+		if (!orig->is_deleted) {
+			int prev_row_cnt = txn->row_cnt;
+			row_t * row = txn->get_row((HASH_INDEX *)NULL, orig, part_id, RD);
+			if (row == NULL) {
+				if (txn->row_cnt == prev_row_cnt && !orig->is_deleted) {
+					rc = Abort;
+					break;
+				}
+			} else if (_filter(row)) {
+				// written, so the commit bumps the version (or holds the
+				// lock) that a concurrent reader of the row checks.
+				txn->drop_last_read(prev_row_cnt);
+				row = txn->get_row((HASH_INDEX *)NULL, orig, part_id, WR);
+				if (row == NULL || !_filter(row)) {
+					rc = Abort;
+					break;
+				}
+				txn->remove_row(orig);
+				origs[cnt] = orig;
+				rows[cnt] = row;
+				for (uint32_t i = 0; i < _index_cnt; i++)
+					keys[cnt][i] = _keys[i](row);
+				cnt ++;
+			} else {
+				// will be written again. Retry it in a later pass.
+				txn->drop_last_read(prev_row_cnt);
+				stalled = true;
+			}
+		}
+		if (!stalled)
+			frontier = row_id + 1;
+	}
+
+	// the block is found through the partition and the indexes before the
+	// commit removes the hot rows, so no reader misses them. Its readers
+	// wait until the commit is done.
+	ColdBlock * block = NULL;
+	if (rc == RCOK && cnt > 0) {
+		block = ColdBlock::create(_table->get_schema(), rows, cnt);
+		block->next = part->blocks;
+		COMPILER_BARRIER
+		part->blocks = block;
+		for (uint32_t slot = 0; slot < cnt; slot++)
+			for (uint32_t i = 0; i < _index_cnt; i++) {
+				RC rc_update = _indexes[i]->index_update(txn, keys[slot][i],
+					cold_ref(block, slot), part_id);
+				assert(rc_update == RCOK);
+			}
+	}
+	rc = txn->finish(rc);
+	if (block != NULL && rc == RCOK) {
+		COMPILER_BARRIER
+		block->state = ColdBlock::COMMITTED;
+		INC_STATS(txn->get_thd_id(), cold_row_cnt, cnt);
+		INC_STATS(txn->get_thd_id(), cold_bytes, block->size);
+		INC_STATS(txn->get_thd_id(), cold_raw_bytes,
+			cnt * _table->get_schema()->get_tuple_size());
+	} else if (block != NULL) {
+		for (uint32_t slot = 0; slot < cnt; slot++)
+			for (uint32_t i = 0; i < _index_cnt; i++) {
+				RC rc_update = _indexes[i]->index_update(txn, keys[slot][i],
+					origs[slot], part_id);
+				assert(rc_update == RCOK);
+			}
+		// only this thread adds blocks to the partition.
+		part->blocks = block->next;
+		COMPILER_BARRIER
+		block->state = ColdBlock::DROPPED;
+		rcu::s_instance.free_with_fn(block, free_block);
+	}
+	if (rc == RCOK)
+		part->frontier = frontier;
+
+	part->latch = false;
+	return rc;
+}
+
+#endif
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "global.h"
+
+class table_t;
+class row_t;
+class txn_man;
+class Catalog;
+class ORDERED_INDEX;
+
+#if COLD_STORE
+
+// compact() drops the reads of the rows it does not freeze.
+#if !ROW_HEAP || CC_ALG == MICA || CC_ALG == HSTORE || CC_ALG == VLL \
+	|| CC_ALG == MVCC || CC_ALG == TIMESTAMP || CC_ALG == OCC
+#error "COLD_STORE requires ROW_HEAP and a row-level CC algorithm whose reads can be dropped"
+#endif
+
+// An immutable block of rows frozen out of a table partition. A column with
+// at most 256 distinct values in the block is stored as a dictionary and
+// 1-byte codes, any other column is stored plainly.
+class ColdBlock {
+public:
+	// a block is PENDING until the compaction txn that froze its rows ends.
+	enum State { PENDING, COMMITTED, DROPPED };
+
+	static ColdBlock * 	create(Catalog * schema, row_t ** rows, uint32_t row_cnt);
+	void 				destroy();
+	// write row slot into data (the tuple of a row_t of the same table).
+	void 				decode(uint32_t slot, char * data);
+	// waits out a PENDING block. false if the compaction aborted.
+	bool 				wait_commit();
+
+	table_t * 			table;
+	ColdBlock * 		next;
+	volatile State 		state;
+	uint64_t 			size;
+	uint32_t 			row_cnt;
+	uint32_t 			col_cnt;
+private:
+	struct Column {
+		uint32_t 		pos; 		// offset in the tuple
+		uint32_t 		size;
+		uint32_t 		dict_cnt; 	// 0 if the column is stored plainly
+		uint64_t 		payload;	// offset of the dictionary or values
+	};
+	Column * 			get_col(uint32_t col) { return &((Column *)(this + 1))[col]; }
+	char * 				get_payload(Column * col) { return (char *)this + col->payload; }
+};
+
+// Index entries of a frozen row hold a tagged reference to its block and
+// slot instead of a row_t pointer. Row pointers are at least 8-byte aligned,
+// so the low bit tells them apart.
+inline row_t * cold_ref(ColdBlock * block, uint32_t slot) {
+	return (row_t *) ((uint64_t)block | ((uint64_t)slot << 48) | 1);
+}
+inline bool is_cold_ref(row_t * row) { return (uint64_t)row & 1; }
+inline ColdBlock * cold_ref_block(row_t * ref) {
+	return (ColdBlock *) ((uint64_t)ref & ((1UL << 48) - 2));
+}
+inline uint32_t cold_ref_slot(row_t * ref) { return (uint64_t)ref >> 48; }
+
+// Frozen rows of a table. The workload enables it with a filter that tells
+// whether a row will never be written again, and the ordered indexes that
+// must be repointed to the frozen rows.
+class ColdStore {
+public:
+	typedef bool (*filter_t)(row_t * row);
+	typedef idx_key_t (*key_t)(row_t * row);
+
+	void 		init(table_t * table, filter_t filter);
+	void 		add_index(ORDERED_INDEX * index, key_t key);
+	// freeze up to COLD_BLOCK_ROWS rows of the partition. The rows are
+	// written and removed through txn, so only committed data is frozen and
+	// a concurrent reader of a hot row fails its validation (or waits for
+	// the lock). Does nothing if another thread is compacting the partition.
+	RC 			compact(txn_man * txn, uint64_t part_id);
+	// the newest block of the partition. Blocks are linked by next.
+	ColdBlock * get_blocks(uint64_t part_id) { return _parts[part_id].blocks; }
+private:
+	struct Part {
+		volatile bool 		latch;
+		// slots below frontier are frozen, deleted or never allocated.
+		uint64_t 			frontier;
+		ColdBlock * volatile blocks;
+		char 				pad[CL_SIZE - sizeof(uint64_t) * 3];
+	};
+	static const int MAX_COLD_INDEX = 4;
+
+	table_t * 	_table;
+	filter_t 	_filter;
+	uint32_t 	_index_cnt;
+	ORDERED_INDEX * _indexes[MAX_COLD_INDEX];
+	key_t 		_keys[MAX_COLD_INDEX];
+	Part * 		_parts;
+};
+
+#endif
@@ -12,7 +12,7 @@ RC IndexArray::init(uint64_t part_cnt, uint64_t bucket_cnt) {
 
   locked = false;
   size = bucket_cnt;
-  arr = (row_t**)mem_allocator.alloc(sizeof(row_t*) * size, 0);
+  arr = (row_t**)mem_allocator.alloc_huge(sizeof(row_t*) * size, 0);
   for (size_t i = 0; i < size; i++) arr[i] = reinterpret_cast<row_t*>(-1);
   return RCOK;
 }
@@ -24,7 +24,7 @@ RC IndexArray::init(uint64_t part_cnt, table_t* table, uint64_t bucket_cnt) {
 
   locked = false;
   size = bucket_cnt;
-  arr = (row_t**)mem_allocator.alloc(sizeof(row_t*) * size, 0);
+  arr = (row_t**)mem_allocator.alloc_huge(sizeof(row_t*) * size, 0);
   for (size_t i = 0; i < size; i++) arr[i] = reinterpret_cast<row_t*>(-1);
   return RCOK;
 }
@@ -46,12 +46,12 @@ RC IndexArray::index_insert(txn_man* txn, idx_key_t key, row_t* row, int part_id
 
   if (size <= key) {
     size_t new_size = (key + 1) * 2;
-    auto new_arr = (row_t**)mem_allocator.alloc(sizeof(row_t*) * new_size, 0);
+    auto new_arr = (row_t**)mem_allocator.alloc_huge(sizeof(row_t*) * new_size, 0);
     memcpy(new_arr, arr, sizeof(row_t*) * size);
     for (size_t i = size; i < new_size; i++)
       new_arr[i] = reinterpret_cast<row_t*>(-1);
 
-    mem_allocator.free(arr, sizeof(row_t*) * size);
+    mem_allocator.free_huge(arr, sizeof(row_t*) * size);
 
     arr = new_arr;
     size = new_size;
@@ -19,7 +19,7 @@ RC IndexHash::init(uint64_t part_cnt, uint64_t bucket_cnt) {
 #endif
     mem_allocator.register_thread(i % g_thread_cnt);
 
-    _buckets[i] = (BucketHeader*)mem_allocator.alloc(
+    _buckets[i] = (BucketHeader*)mem_allocator.alloc_huge(
         sizeof(BucketHeader) * _bucket_cnt_per_part, i);
     for (uint32_t n = 0; n < _bucket_cnt_per_part; n++) _buckets[i][n].init();
   }
@@ -36,6 +36,7 @@ class IndexMBTree_cb
   void on_resp_node(const concurrent_mbtree::node_opaque_t* n,
                     uint64_t version) override {
 #if TPCC_VALIDATE_NODE
+    if (txn_ == NULL) return;
     auto it = txn_->node_map.find((void*)n);
     if (it == txn_->node_map.end()) {
       // printf("index node seen: %p %" PRIu64 "\n", n, version);
@@ -134,6 +135,7 @@ RC IndexMBTree::index_read(txn_man* txn, idx_key_t key, row_t** row,
   concurrent_mbtree::versioned_node_t search_info;
   if (!idx->search(mbtree_key, *row, &search_info)) {
 #if TPCC_VALIDATE_NODE
+    if (txn == NULL) return ERROR;
     auto it = txn->node_map.find((void*)search_info.first);
     if (it == txn->node_map.end()) {
       txn->node_map.emplace_hint(it, (void*)search_info.first,
@@ -222,6 +224,18 @@ RC IndexMBTree::index_remove(txn_man* txn, idx_key_t key, row_t*, int part_id) {
   return RCOK;
 }
 
+RC IndexMBTree::index_update(txn_man* txn, idx_key_t key, row_t* row,
+                             int part_id) {
+  auto idx = reinterpret_cast<concurrent_mbtree*>(btree_idx[part_id]);
+
+  u64_varkey mbtree_key(key);
+
+  // insert() overwrites the value of an existing key and returns false.
+  if (idx->insert(mbtree_key, row)) return ERROR;
+
+  return RCOK;
+}
+
 RC IndexMBTree::validate(txn_man* txn) {
 #if TPCC_VALIDATE_NODE
 
@@ -17,6 +17,8 @@ class IndexMBTree : public index_base {
   RC index_insert(txn_man* txn, idx_key_t key, row_t* row, int part_id);
   // This method ignores the second row_t* argument.
   RC index_remove(txn_man* txn, idx_key_t key, row_t*, int part_id);
+  // Replaces the row of an existing key.
+  RC index_update(txn_man* txn, idx_key_t key, row_t* row, int part_id);
 
   RC index_read(txn_man* txn, idx_key_t key, row_t** row, int part_id);
   RC index_read_multiple(txn_man* txn, idx_key_t key, row_t** rows,
@@ -15,7 +15,7 @@
 #include "mem_alloc.h"
 #include "manager.h"
 
-#if defined(USE_INLINED_DATA) && (CC_ALG == DL_DETECT || CC_ALG == NO_WAIT || CC_ALG == WAIT_DIE || CC_ALG == SILO || CC_ALG == TICTOC)
+#if defined(USE_INLINED_DATA) && (CC_ALG == DL_DETECT || CC_ALG == NO_WAIT || CC_ALG == WAIT_DIE || CC_ALG == SILO || CC_ALG == TICTOC || CC_ALG == HEKATON)
 
 size_t row_t::alloc_size(table_t* t) { return sizeof(row_t) + t->get_schema()->get_tuple_size(); }
 
@@ -34,7 +34,11 @@ row_t::init(table_t * host_table, uint64_t part_id, uint64_t row_id) {
 	_row_id = row_id;
 	_part_id = part_id;
 	this->table = host_table;
+	// [ROW_HEAP] the slot stays deleted until table_t::get_new_row() or the
+	// commit of the inserting txn publishes it.
+#if !ROW_HEAP || CC_ALG == MICA
 	is_deleted = 0;
+#endif
 #if CC_ALG == MICA
   // We ignore the given row_id argument to init() because it contains an
   // uninitialized value and is not used by the workload.
@@ -82,7 +86,7 @@ row_t::init(table_t * host_table, uint64_t part_id, uint64_t row_id) {
 		break;
 	}
 #else
-#if defined(USE_INLINED_DATA) && (CC_ALG == DL_DETECT || CC_ALG == NO_WAIT || CC_ALG == WAIT_DIE || CC_ALG == SILO || CC_ALG == TICTOC)
+#if defined(USE_INLINED_DATA) && (CC_ALG == DL_DETECT || CC_ALG == NO_WAIT || CC_ALG == WAIT_DIE || CC_ALG == SILO || CC_ALG == TICTOC || CC_ALG == HEKATON)
 	// We can just use &data[0].
 #else
 	Catalog * schema = host_table->get_schema();
@@ -96,7 +100,7 @@ void
 row_t::init(int size)
 {
 #if CC_ALG != MICA
-#if defined(USE_INLINED_DATA) && (CC_ALG == DL_DETECT || CC_ALG == NO_WAIT || CC_ALG == WAIT_DIE || CC_ALG == SILO || CC_ALG == TICTOC)
+#if defined(USE_INLINED_DATA) && (CC_ALG == DL_DETECT || CC_ALG == NO_WAIT || CC_ALG == WAIT_DIE || CC_ALG == SILO || CC_ALG == TICTOC || CC_ALG == HEKATON)
 	// We can just use &data[0].
 #else
 	data = (char *) mem_allocator.alloc(size, 64);
@@ -129,7 +133,11 @@ void row_t::init_manager(row_t * row) {
 #elif CC_ALG == MVCC
     manager = (Row_mvcc *) mem_allocator.alloc(sizeof(Row_mvcc), _part_id);
 #elif CC_ALG == HEKATON
+#ifdef USE_INLINED_DATA
+	// We can just use &manager[0].
+#else
     manager = (Row_hekaton *) mem_allocator.alloc(sizeof(Row_hekaton), _part_id);
+#endif
 #elif CC_ALG == OCC
     manager = (Row_occ *) mem_allocator.alloc(sizeof(Row_occ), _part_id);
 #elif CC_ALG == TICTOC
@@ -177,6 +185,9 @@ void row_t::set_value(int id, void * ptr) {
 	int datasize = get_schema()->get_field_size(id);
 	int pos = get_schema()->get_field_index(id);
 	memcpy( &data[pos], ptr, datasize);
+#if DELTA_WRITE
+	mark_dirty(pos, datasize);
+#endif
 #else
 	int datasize = get_schema()->get_field_size(id);
 	int pos = get_schema()->get_field_index(id);
@@ -189,6 +200,9 @@ void row_t::set_value(int id, void * ptr, int size) {
 #if !TPCC_CF
 	int pos = get_schema()->get_field_index(id);
 	memcpy( &data[pos], ptr, size);
+#if DELTA_WRITE
+	mark_dirty(pos, size);
+#endif
 #else
 	int pos = get_schema()->get_field_index(id);
         int cf_id = get_schema()->get_field_cf_id(id);
@@ -252,6 +266,9 @@ void row_t::set_data(char * data, uint64_t size) {
 	assert(false);
 #endif
 	memcpy(this->data, data, size);
+#if DELTA_WRITE
+	mark_dirty(0, size);
+#endif
 }
 #endif
 
@@ -262,12 +279,37 @@ void row_t::copy(row_t * src) {
 	assert(false);
 #else
 	set_data(src->get_data(), src->get_tuple_size());
+#if DELTA_WRITE
+	dirty_lines = 0;
+#endif
 #endif
 }
 
+#if DELTA_WRITE
+static_assert(MAX_TUPLE_SIZE <= 64 * CL_SIZE, "dirty_lines has one bit per line");
+
+void row_t::apply_delta(row_t * src) {
+	uint64_t size = src->get_tuple_size();
+	uint64_t lines = src->dirty_lines;
+	while (lines != 0) {
+		uint64_t first = __builtin_ctzl(lines);
+		uint64_t last = first;
+		// copy each run of dirty lines with one memcpy.
+		while (last + 1 < 64 && (lines & (1UL << (last + 1))))
+			last ++;
+		uint64_t pos = first * CL_SIZE;
+		uint64_t end = (last + 1) * CL_SIZE;
+		if (end > size)
+			end = size;
+		memcpy(&data[pos], &src->data[pos], end - pos);
+		lines &= (last == 63 ? 0 : ~0UL << (last + 1));
+	}
+}
+#endif
+
 void row_t::free_row() {
 #if CC_ALG != MICA
-#if defined(USE_INLINED_DATA) && (CC_ALG == DL_DETECT || CC_ALG == NO_WAIT || CC_ALG == WAIT_DIE || CC_ALG == SILO || CC_ALG == TICTOC)
+#if defined(USE_INLINED_DATA) && (CC_ALG == DL_DETECT || CC_ALG == NO_WAIT || CC_ALG == WAIT_DIE || CC_ALG == SILO || CC_ALG == TICTOC || CC_ALG == HEKATON)
 #else
 	free(data);
 #endif
@@ -307,7 +349,11 @@ RC row_t::get_row(access_t type, txn_man * txn, row_t *& row) {
 		uint64_t endtime;
 		txn->lock_abort = false;
 		INC_STATS(txn->get_thd_id(), wait_cnt, 1);
-		while (!txn->lock_ready && !txn->lock_abort)
+		while (!txn->wait_entry->ready && !txn->lock_abort
+#if BAMBOO
+				&& !txn->bb_abort
+#endif
+				)
 		{
 #if CC_ALG == WAIT_DIE
 			continue;
@@ -347,9 +393,14 @@ RC row_t::get_row(access_t type, txn_man * txn, row_t *& row) {
 				PAUSE
 #endif
 		}
-		if (txn->lock_ready)
+#if CC_ALG == DL_DETECT
+		// the edges are stale once the wait is over.
+		if (dep_added)
+			dl_detector.clear_dep(txn->get_txn_id());
+#endif
+		if (txn->wait_entry->ready)
 			rc = RCOK;
-		else if (txn->lock_abort) {
+		else {
 			rc = Abort;
 			return_row(type, txn, NULL);
 		}
@@ -500,10 +551,15 @@ RC row_t::get_row(access_t type, txn_man* txn, table_t* table,
 void row_t::return_row(access_t type, txn_man * txn, row_t * row) {
 #if CC_ALG == WAIT_DIE || CC_ALG == NO_WAIT || CC_ALG == DL_DETECT
 	assert (row == NULL || row == this || type == XP);
+#if BAMBOO
+	// the lock manager recovers from previous writes after cascading aborts.
+	this->manager->lock_release(txn, type == XP, (ROLL_BACK && type == XP) ? row : NULL);
+#else
 	if (ROLL_BACK && type == XP) {// recover from previous writes.
 		this->copy(row);
 	}
 	this->manager->lock_release(txn);
+#endif
 #elif CC_ALG == TIMESTAMP || CC_ALG == MVCC
 	// for RD or SCAN or XP, the row should be deleted.
 	// because all WR should be companied by a RD
@@ -73,6 +73,15 @@ public:
 	uint64_t get_row_id() { return _row_id; };
 
 	void copy(row_t * src);
+#if DELTA_WRITE
+	// write back only the lines modified in the local copy src.
+	void apply_delta(row_t * src);
+	void mark_dirty(uint64_t pos, uint64_t size) {
+		uint64_t first = pos / CL_SIZE;
+		uint64_t last = (pos + size - 1) / CL_SIZE;
+		dirty_lines |= (last == 63 ? ~0UL : (1UL << (last + 1)) - 1) & (~0UL << first);
+	}
+#endif
 
 	void 		set_primary_key(uint64_t key) { _primary_key = key; };
 	uint64_t 	get_primary_key() {return _primary_key; };
@@ -136,6 +145,10 @@ private:
 public:
 	table_t * table;
 	volatile uint8_t			is_deleted;
+#if DELTA_WRITE
+	// bit i is set when line i of the data was modified since the last copy().
+	uint64_t 		dirty_lines;
+#endif
 	
   #if CC_ALG == DL_DETECT || CC_ALG == NO_WAIT || CC_ALG == WAIT_DIE
 		#if defined(USE_INLINED_DATA)	
@@ -148,7 +161,11 @@ public:
   #elif CC_ALG == MVCC
 	  	Row_mvcc * manager;
   #elif CC_ALG == HEKATON
+		#if defined(USE_INLINED_DATA)
+  	Row_hekaton manager[1];
+		#else
   	Row_hekaton * manager;
+		#endif
   #elif CC_ALG == OCC
   	Row_occ * manager;
   #elif CC_ALG == TICTOC
@@ -171,8 +188,12 @@ public:
 	void set_row_id(uint64_t row_id) { _row_id = row_id; }
 
 
-#if defined(USE_INLINED_DATA) && (CC_ALG == DL_DETECT || CC_ALG == NO_WAIT || CC_ALG == WAIT_DIE || CC_ALG == SILO || CC_ALG == TICTOC)
+#if defined(USE_INLINED_DATA) && (CC_ALG == DL_DETECT || CC_ALG == NO_WAIT || CC_ALG == WAIT_DIE || CC_ALG == SILO || CC_ALG == TICTOC || CC_ALG == HEKATON)
+#if COLUMN_GROUP
+	char data[0] __attribute__((aligned(CL_SIZE)));
+#else
 	char data[0] __attribute__((aligned(8)));
+#endif
 #else
 #if !TPCC_CF
 	char * data;
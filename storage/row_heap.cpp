@@ -0,0 +1,69 @@
+#include "row_heap.h"
+#include "helper.h"
+#include "mem_alloc.h"
+#include "row.h"
+
+void RowHeap::init(uint64_t row_size, uint64_t part_id) {
+	// rows do not share cache lines, as with one allocation per row.
+	_row_size = (row_size + CL_SIZE - 1) & ~(CL_SIZE - 1);
+	_rows_per_extent = ROW_HEAP_EXTENT_SIZE / _row_size;
+	assert(_rows_per_extent > 0);
+	_part_id = part_id;
+	_extents = NULL;
+	_extent_cap = 0;
+	_extent_cnt = 0;
+	_row_cnt = 0;
+	_latch = false;
+}
+
+void RowHeap::get_latch() {
+	while (_latch || !ATOM_CAS(_latch, false, true))
+		PAUSE
+}
+
+void RowHeap::release_latch() {
+	COMPILER_BARRIER
+	_latch = false;
+}
+
+void RowHeap::add_extent() {
+	if (_extent_cnt == _extent_cap) {
+		uint64_t cap = _extent_cap == 0 ? 16 : _extent_cap * 2;
+		char ** extents = (char **) mem_allocator.alloc(sizeof(char *) * cap, _part_id);
+		for (uint64_t i = 0; i < _extent_cnt; i++)
+			extents[i] = _extents[i];
+		COMPILER_BARRIER
+		_extents = extents;
+		_extent_cap = cap;
+	}
+	char * extent = (char *) mem_allocator.alloc_huge(ROW_HEAP_EXTENT_SIZE, _part_id);
+	// slots not handed out yet look deleted to a scan.
+	for (uint64_t i = 0; i < _rows_per_extent; i++)
+		((row_t *) (extent + i * _row_size))->is_deleted = 1;
+	_extents[_extent_cnt ++] = extent;
+}
+
+row_t * RowHeap::alloc_row(uint64_t &row_id) {
+	get_latch();
+	if (!_free_slots.empty()) {
+		row_id = _free_slots.back();
+		_free_slots.pop_back();
+	} else {
+		row_id = _row_cnt;
+		if (row_id == _extent_cnt * _rows_per_extent)
+			add_extent();
+		// the extent is published before the slot is counted. The slot
+		// stays deleted until table_t::get_new_row() publishes the row.
+		COMPILER_BARRIER
+		_row_cnt = row_id + 1;
+	}
+	release_latch();
+	return get_row(row_id);
+}
+
+void RowHeap::free_row(uint64_t row_id) {
+	assert(row_id < _row_cnt);
+	get_latch();
+	_free_slots.push_back(row_id);
+	release_latch();
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "global.h"
+#include <vector>
+
+#if ROW_HEAP && INDEX_STRUCT == IDX_MICA && !RCU_ALLOC
+#error "ROW_HEAP reclaims slots through RCU, which needs the RCU regions of the txns"
+#endif
+
+class row_t;
+
+// Rows of one partition of a table, carved from ROW_HEAP_EXTENT_SIZE
+// extents. A row id is the slot number in the partition, so it is stable
+// and translates to the row address without an index.
+// table_t::delete_row() hands a slot to free_row() through RCU, so a slot
+// is reused only after every txn that might still hold a pointer to the
+// deleted row has left its RCU region.
+class RowHeap {
+public:
+	void 		init(uint64_t row_size, uint64_t part_id);
+	row_t * 	alloc_row(uint64_t &row_id);
+	void 		free_row(uint64_t row_id);
+	// NULL if the slot has never been allocated.
+	row_t * 	get_row(uint64_t row_id) {
+		if (row_id >= _row_cnt)
+			return NULL;
+		return (row_t *) (_extents[row_id / _rows_per_extent]
+			+ (row_id % _rows_per_extent) * _row_size);
+	}
+	// # of slots ever allocated. A scan visits slots [0, get_row_cnt()).
+	uint64_t 	get_row_cnt() { return _row_cnt; }
+private:
+	void 		get_latch();
+	void 		release_latch();
+	void 		add_extent();
+
+	uint64_t 	_row_size;
+	uint64_t 	_rows_per_extent;
+	uint64_t 	_part_id;
+	// replaced by a larger copy when full. Old copies are never freed since
+	// readers may still use them.
+	char ** volatile _extents;
+	uint64_t 	_extent_cap;
+	uint64_t 	_extent_cnt;
+	volatile uint64_t _row_cnt;
+	volatile bool _latch;
+	std::vector<uint64_t> _free_slots;
+	char 		_pad[CL_SIZE];
+};
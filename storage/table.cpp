@@ -1,15 +1,34 @@
+#define CONFIG_H "silo/config/config-perf.h"
+#include "silo/rcu.h"
+#ifdef NDEBUG
+#undef NDEBUG
+#endif
+
 #include "global.h"
 #include "helper.h"
 #include "table.h"
 #include "catalog.h"
 #include "row.h"
 #include "mem_alloc.h"
+#include "row_heap.h"
+#include "cold_store.h"
 
 void table_t::init(Catalog* schema, uint64_t part_cnt) {
   this->table_name = schema->table_name;
   this->schema = schema;
   this->part_cnt = part_cnt;
 
+#if ROW_HEAP && CC_ALG != MICA
+  heaps = (RowHeap*)mem_allocator.alloc(sizeof(RowHeap) * part_cnt, -1);
+  for (uint64_t part_id = 0; part_id < part_cnt; part_id++) {
+    new (&heaps[part_id]) RowHeap();
+    heaps[part_id].init(row_t::alloc_size(this), part_id);
+  }
+#endif
+#if COLD_STORE
+  cold = NULL;
+#endif
+
 #if CC_ALG == MICA
 
   for (uint64_t part_id = 0; part_id < part_cnt; part_id++) {
@@ -62,7 +81,8 @@ RC table_t::get_new_row(row_t*& row) {
 }
 
 // the row is not stored locally. the pointer must be maintained by index structure.
-RC table_t::get_new_row(row_t*& row, uint64_t part_id, uint64_t& row_id) {
+RC table_t::get_new_row(row_t*& row, uint64_t part_id, uint64_t& row_id,
+                        bool visible) {
   RC rc = RCOK;
 
 // XXX: this has a race condition; should be used just for non-critical purposes
@@ -71,11 +91,56 @@ RC table_t::get_new_row(row_t*& row, uint64_t part_id, uint64_t& row_id) {
 #if CC_ALG == MICA
   assert(row != NULL);
 // We do not need a new row instance because MICA has it.
+#elif ROW_HEAP
+  assert(part_id < part_cnt);
+  row = heaps[part_id].alloc_row(row_id);
 #else
   row = (row_t*)mem_allocator.alloc(row_t::alloc_size(this), part_id);
 #endif
   rc = row->init(this, part_id, row_id);
   row->init_manager(row);
+#if ROW_HEAP && CC_ALG != MICA
+  // a scan may see the slot only once the row is initialized.
+  if (visible) {
+    COMPILER_BARRIER
+    row->is_deleted = 0;
+  }
+#else
+  (void)visible;
+#endif
 
   return rc;
 }
+
+void table_t::delete_row(row_t* row) {
+#if CC_ALG == MICA
+  assert(false);
+#elif ROW_HEAP
+  rcu::s_instance.free_with_fn(row, free_slot);
+#else
+  mem_allocator.free(row, row_t::alloc_size(this));
+#endif
+}
+
+#if ROW_HEAP && CC_ALG != MICA
+void table_t::free_slot(void* row) {
+  auto r = (row_t*)row;
+  r->get_table()->heaps[r->get_part_id()].free_row(r->get_row_id());
+}
+
+row_t* table_t::get_row(uint64_t part_id, uint64_t row_id) {
+  return heaps[part_id].get_row(row_id);
+}
+
+uint64_t table_t::get_row_cnt(uint64_t part_id) {
+  return heaps[part_id].get_row_cnt();
+}
+#endif
+
+#if COLD_STORE
+void table_t::enable_cold(ColdStore::filter_t filter) {
+  assert(cold == NULL);
+  cold = (ColdStore*)mem_allocator.alloc(sizeof(ColdStore), -1);
+  cold->init(this, filter);
+}
+#endif
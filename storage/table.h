@@ -1,11 +1,14 @@
 #pragma once
 
 #include "global.h"
+#include "cold_store.h"
 
-// TODO sequential scan is not supported yet.
-// only index access is supported for table.
+// With ROW_HEAP, rows are stored per partition and can be reached by
+// (part_id, row_id) without an index. Otherwise only index access is
+// supported for table.
 class Catalog;
 class row_t;
+class RowHeap;
 
 class table_t
 {
@@ -15,9 +18,25 @@ public:
 	// records for new rows. get_new_row returns the pointer to a
 	// new row.
 	RC get_new_row(row_t *& row); // this is equivalent to insert()
-	RC get_new_row(row_t *& row, uint64_t part_id, uint64_t &row_id);
-
-	void delete_row(); // TODO delete_row is not supportet yet
+	// [ROW_HEAP] a row that is not visible is skipped by scans until
+	// txn_man::apply_index_changes() publishes it.
+	RC get_new_row(row_t *& row, uint64_t part_id, uint64_t &row_id,
+		bool visible = true);
+
+	// returns the storage of a row that is no longer reachable.
+	void delete_row(row_t * row);
+#if ROW_HEAP && CC_ALG != MICA
+	// NULL for a slot that has never been allocated.
+	row_t * get_row(uint64_t part_id, uint64_t row_id);
+	// # of row slots in the partition. Deleted slots have is_deleted set.
+	uint64_t get_row_cnt(uint64_t part_id);
+	uint64_t get_part_cnt() { return part_cnt; }
+#endif
+#if COLD_STORE
+	// rows passing filter may be frozen. NULL until enable_cold().
+	void enable_cold(ColdStore::filter_t filter);
+	ColdStore * 	cold;
+#endif
 
 	// uint64_t get_table_size() { return cur_tab_size; };
 	Catalog * get_schema() { return schema; };
@@ -34,5 +53,11 @@ private:
 	const char * 	table_name;
 	// uint64_t  		cur_tab_size;
 	uint64_t part_cnt;
-	char 			pad[CL_SIZE - sizeof(void *)*3];
+#if ROW_HEAP && CC_ALG != MICA
+	RowHeap * 		heaps;
+	// [ROW_HEAP] the RCU callback of delete_row().
+	static void 	free_slot(void * row);
+#endif
+	char 			pad[CL_SIZE - sizeof(void *)
+		* (3 + (ROW_HEAP && CC_ALG != MICA) + COLD_STORE)];
 };
@@ -0,0 +1,193 @@
+// built for every CC_ALG. table_scan.h rejects the unsupported ones only
+// for its users.
+#define TABLE_SCAN_IMPL
+#include "table_scan.h"
+#include "table.h"
+#include "catalog.h"
+#include "row.h"
+#include "txn.h"
+#include "wl.h"
+#include "index_hash.h"
+#include "cold_store.h"
+
+#if ROW_HEAP && CC_ALG != MICA && !defined(TABLE_SCAN_UNSUPPORTED)
+
+void table_scan::init(txn_man * txn, table_t * table,
+		uint64_t part_begin, uint64_t part_end, bool read_committed) {
+	assert(part_begin <= part_end && part_end <= table->get_part_cnt());
+	_txn = txn;
+	_table = table;
+	_part_id = part_begin;
+	_part_end = part_end;
+	_row_id = 0;
+	_read_committed = read_committed;
+#if COLD_STORE
+	_in_cold = false;
+#endif
+	_preds.clear();
+}
+
+table_scan::Pred * table_scan::add_pred(const char * col_name, ScanOp op) {
+	Pred pred;
+	pred.col_id = _table->get_schema()->get_field_id(col_name);
+	pred.op = op;
+	_preds.push_back(pred);
+	return &_preds.back();
+}
+
+void table_scan::add_pred(const char * col_name, ScanOp op, int64_t value) {
+	Pred * pred = add_pred(col_name, op);
+	pred->type = PRED_INT;
+	pred->ival = value;
+}
+
+void table_scan::add_pred(const char * col_name, ScanOp op, double value) {
+	Pred * pred = add_pred(col_name, op);
+	pred->type = PRED_DOUBLE;
+	pred->dval = value;
+}
+
+void table_scan::add_pred(const char * col_name, ScanOp op, const char * value) {
+	Pred * pred = add_pred(col_name, op);
+	pred->type = PRED_STRING;
+	pred->sval = value;
+}
+
+template <typename T>
+bool table_scan::compare(T a, T b, ScanOp op) {
+	switch (op) {
+	case SCAN_EQ : return a == b;
+	case SCAN_NE : return a != b;
+	case SCAN_LT : return a < b;
+	case SCAN_LE : return a <= b;
+	case SCAN_GT : return a > b;
+	case SCAN_GE : return a >= b;
+	}
+	assert(false);
+	return false;
+}
+
+bool table_scan::match(row_t * row) {
+	Catalog * schema = _table->get_schema();
+	for (auto & pred : _preds) {
+		char * value = row->get_value(pred.col_id);
+		uint64_t size = schema->get_field_size(pred.col_id);
+		bool ok;
+		if (pred.type == PRED_INT) {
+			// integer columns are 4 or 8 bytes.
+			int64_t v = 0;
+			if (size == sizeof(int32_t)) {
+				int32_t v32;
+				memcpy(&v32, value, sizeof(v32));
+				v = v32;
+			} else {
+				assert(size == sizeof(int64_t));
+				memcpy(&v, value, sizeof(v));
+			}
+			ok = compare(v, pred.ival, pred.op);
+		} else if (pred.type == PRED_DOUBLE) {
+			double v;
+			assert(size == sizeof(double));
+			memcpy(&v, value, sizeof(v));
+			ok = compare(v, pred.dval, pred.op);
+		} else {
+			ok = compare(strncmp(value, pred.sval, size), 0, pred.op);
+		}
+		if (!ok)
+			return false;
+	}
+	return true;
+}
+
+RC table_scan::next(row_t *& row) {
+	while (_part_id < _part_end) {
+		// a long scan must not keep running past the end of the run.
+		if (_txn->h_wl->sim_done)
+			return Abort;
+		if (_row_id >= _table->get_row_cnt(_part_id)) {
+#if COLD_STORE
+			if (_table->cold != NULL) {
+				if (!_in_cold) {
+					_in_cold = true;
+					_block = _table->cold->get_blocks(_part_id);
+					_slot = 0;
+				}
+				RC rc = next_cold(row);
+				if (rc != RCOK || row != NULL)
+					return rc;
+				_in_cold = false;
+			}
+#endif
+			_part_id ++;
+			_row_id = 0;
+			continue;
+		}
+		row_t * orig = _table->get_row(_part_id, _row_id ++);
+		if (orig->is_deleted)
+			continue;
+		int row_cnt = _txn->row_cnt;
+		row = _txn->get_row((HASH_INDEX *)NULL, orig, _part_id, RD);
+		if (row == NULL) {
+			// deleted while being read, or aborted by the CC.
+			if (_txn->row_cnt == row_cnt && !orig->is_deleted) {
+#if CC_ALG == NO_WAIT
+				// a read-committed scan holds no lock a writer waits for,
+				// so it waits for the row instead of restarting the scan.
+				if (_read_committed && _txn->row_cnt < MAX_ROW_PER_TXN) {
+					_row_id --;
+					PAUSE
+					continue;
+				}
+#endif
+				return Abort;
+			}
+			continue;
+		}
+		if (match(row)) {
+			_last_cnt = row_cnt;
+			return RCOK;
+		}
+		if (_read_committed)
+			_txn->drop_last_read(row_cnt);
+	}
+	row = NULL;
+	return RCOK;
+}
+
+void table_scan::release() {
+	assert(_read_committed);
+#if COLD_STORE
+	if (_in_cold) {
+		_txn->cold_cnt = _last_cnt;
+		return;
+	}
+#endif
+	_txn->drop_last_read(_last_cnt);
+}
+
+#if COLD_STORE
+RC table_scan::next_cold(row_t *& row) {
+	while (_block != NULL) {
+		if (_slot >= _block->row_cnt) {
+			_block = _block->next;
+			_slot = 0;
+			continue;
+		}
+		int cold_cnt = _txn->cold_cnt;
+		row = _txn->get_row((HASH_INDEX *)NULL, cold_ref(_block, _slot ++),
+			_part_id, RD);
+		if (row == NULL)
+			return Abort;
+		if (match(row)) {
+			_last_cnt = cold_cnt;
+			return RCOK;
+		}
+		// reuse the copy for the next frozen row.
+		_txn->cold_cnt = cold_cnt;
+	}
+	row = NULL;
+	return RCOK;
+}
+#endif
+
+#endif
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "global.h"
+
+class table_t;
+class row_t;
+class txn_man;
+class ColdBlock;
+
+// the reads of these CC algorithms leave state in the row manager, which
+// txn_man::drop_last_read() cannot undo.
+#if ROW_HEAP && (CC_ALG == MVCC || CC_ALG == TIMESTAMP || CC_ALG == OCC \
+	|| CC_ALG == VLL)
+#define TABLE_SCAN_UNSUPPORTED
+#ifndef TABLE_SCAN_IMPL
+#error "table_scan does not support MVCC, TIMESTAMP, OCC and VLL"
+#endif
+#endif
+
+#if ROW_HEAP && CC_ALG != MICA && !defined(TABLE_SCAN_UNSUPPORTED)
+
+enum ScanOp { SCAN_EQ, SCAN_NE, SCAN_LT, SCAN_LE, SCAN_GT, SCAN_GE };
+
+// Sequential scan over the partitions [part_begin, part_end) of a table
+// in storage order. Each row is read through the active CC algorithm with
+// txn_man::get_row(), so a returned row is a consistent copy (Silo/TicToc
+// version, Hekaton visible version, or a locked row for 2PL).
+// By default every row read stays in the txn's accesses, including the
+// rows failing the predicates, so it is validated at commit (or stays
+// locked), and next() returns Abort once the txn holds MAX_ROW_PER_TXN
+// rows, so only small tables can be scanned this way. With
+// read_committed, the rows failing the predicates are dropped again and
+// release() may drop the returned ones. A row updated into the predicate range before commit
+// is then missed under Silo/TicToc.
+// Disjoint partition ranges can be scanned by different threads.
+// next() returns Abort once the run is over (sim_done).
+// [COLD_STORE] the frozen rows of a partition follow its heap rows.
+class table_scan {
+public:
+	void 		init(txn_man * txn, table_t * table,
+					uint64_t part_begin, uint64_t part_end,
+					bool read_committed = false);
+	// predicates are ANDed. The value is compared by the column type.
+	void 		add_pred(const char * col_name, ScanOp op, int64_t value);
+	void 		add_pred(const char * col_name, ScanOp op, double value);
+	void 		add_pred(const char * col_name, ScanOp op, const char * value);
+	// row is NULL at the end of the scan. Returns Abort if the CC aborts.
+	RC 			next(row_t *& row);
+	// drop the row returned by the last next() from the txn's accesses
+	// once the caller has consumed it, so an aggregate over the whole
+	// table tracks no rows. Must come before any other row access. Only
+	// with read_committed.
+	void 		release();
+private:
+	enum PredType { PRED_INT, PRED_DOUBLE, PRED_STRING };
+	struct Pred {
+		uint64_t 		col_id;
+		ScanOp 			op;
+		PredType 		type;
+		int64_t 		ival;
+		double 			dval;
+		const char * 	sval;
+	};
+	Pred * 		add_pred(const char * col_name, ScanOp op);
+	bool 		match(row_t * row);
+	template <typename T>
+	static bool compare(T a, T b, ScanOp op);
+
+	txn_man * 	_txn;
+	table_t * 	_table;
+	uint64_t 	_part_id;
+	uint64_t 	_part_end;
+	uint64_t 	_row_id;
+	bool 		_read_committed;
+	// row_cnt (cold_cnt) before reading the last returned row.
+	int 		_last_cnt;
+#if COLD_STORE
+	// next frozen row of the partition, after its heap rows.
+	bool 		_in_cold;
+	ColdBlock * _block;
+	uint32_t 	_slot;
+	RC 			next_cold(row_t *& row);
+#endif
+	std::vector<Pred> _preds;
+};
+
+#endif
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <tuple>
+#include "global.h"
+#include "catalog.h"
+#include "row.h"
+
+// Compile-time mirror of a table schema. The column offsets are computed the
+// same way Catalog::add_col()/finalize() compute them, so typed accessors
+// compile down to a load/store at a constant offset of the tuple data.
+// The runtime Catalog is still built from the schema file for introspection;
+// TypedSchema::check() verifies that both agree.
+//
+// A string column is declared as Col<char, size>; get_field() returns a
+// pointer to it.
+template <typename T, uint32_t Size = sizeof(T), uint32_t CfId = 0>
+struct Col {
+	typedef T type;
+	static constexpr uint32_t size = Size;
+	static constexpr uint32_t cf_id = CfId;
+};
+
+template <typename... Cols>
+struct TypedSchema {
+	template <int col>
+	using col_t = typename std::tuple_element<col, std::tuple<Cols...> >::type;
+
+	static constexpr uint32_t field_cnt = sizeof...(Cols);
+
+	static constexpr uint32_t size(int col) {
+		constexpr uint32_t sizes[] = {Cols::size...};
+		return sizes[col];
+	}
+	// the families in the schema file are ignored unless a layout uses them.
+	static constexpr uint32_t cf_id(int col) {
+#if TPCC_CF || COLUMN_GROUP
+		constexpr uint32_t cf_ids[] = {Cols::cf_id...};
+		return cf_ids[col];
+#else
+		return 0;
+#endif
+	}
+	// size of all the columns of a column family.
+	static constexpr uint32_t cf_size(uint32_t cf) {
+		uint32_t total = 0;
+		for (uint32_t i = 0; i < field_cnt; i++)
+			if (cf_id(i) == cf)
+				total += size(i);
+		return total;
+	}
+	static constexpr uint32_t cf_count() {
+		uint32_t cnt = 0;
+		for (uint32_t i = 0; i < field_cnt; i++)
+			if (cf_id(i) + 1 > cnt)
+				cnt = cf_id(i) + 1;
+		return cnt;
+	}
+	// start of a column family in the tuple. Only COLUMN_GROUP lays the
+	// families out one after another; TPCC_CF keeps them in separate buffers.
+	static constexpr uint32_t cf_base(uint32_t cf) {
+		uint32_t base = 0;
+#if COLUMN_GROUP
+		for (uint32_t i = 0; i < cf; i++)
+			base = (base + cf_size(i) + CL_SIZE - 1) / CL_SIZE * CL_SIZE;
+#endif
+		return base;
+	}
+	// equals Catalog::get_field_index(col).
+	static constexpr uint32_t offset(int col) {
+		uint32_t pos = cf_base(cf_id(col));
+		for (int i = 0; i < col; i++)
+			if (cf_id(i) == cf_id(col))
+				pos += size(i);
+		return pos;
+	}
+	static constexpr uint32_t tuple_size() {
+#if COLUMN_GROUP
+		return cf_base(cf_count() - 1) + cf_size(cf_count() - 1);
+#else
+		uint32_t total = 0;
+		for (uint32_t i = 0; i < field_cnt; i++)
+			total += size(i);
+		return total;
+#endif
+	}
+
+	static void check(Catalog * schema) {
+		M_ASSERT(schema->get_field_cnt() == field_cnt
+			&& schema->get_tuple_size() == tuple_size(),
+			"%s: tuple does not match the typed schema\n", schema->table_name);
+		for (uint32_t i = 0; i < field_cnt; i++) {
+			M_ASSERT(schema->get_field_size(i) == size(i)
+				&& schema->get_field_index(i) == offset(i),
+				"%s: column %s does not match the typed schema\n",
+				schema->table_name, schema->get_field_name(i));
+		}
+	}
+
+	template <int col>
+	static char * field_ptr(row_t * row) {
+#if TPCC_CF
+		return row->cf_data[cf_id(col)] + offset(col);
+#else
+		return row->get_data() + offset(col);
+#endif
+	}
+};
+
+template <typename S, int col>
+inline typename S::template col_t<col>::type get_field(row_t * row) {
+	typedef typename S::template col_t<col>::type T;
+	static_assert(sizeof(T) == S::size(col), "use get_field_ptr() for strings");
+	T value;
+	memcpy(&value, S::template field_ptr<col>(row), sizeof(T));
+	return value;
+}
+
+template <typename S, int col>
+inline void set_field(row_t * row, typename S::template col_t<col>::type value) {
+	typedef typename S::template col_t<col>::type T;
+	static_assert(sizeof(T) == S::size(col), "use get_field_ptr() for strings");
+	memcpy(S::template field_ptr<col>(row), &value, sizeof(T));
+#if DELTA_WRITE && !TPCC_CF
+	row->mark_dirty(S::offset(col), sizeof(T));
+#endif
+}
+
+// the caller marks the column dirty when writing through the pointer.
+template <typename S, int col>
+inline char * get_field_ptr(row_t * row) {
+	return S::template field_ptr<col>(row);
+}
@@ -7,6 +7,7 @@
 #include "plock.h"
 #include "occ.h"
 #include "vll.h"
+#include "topology.h"
 
 mem_alloc mem_allocator;
 Stats stats;
@@ -15,11 +16,13 @@ Manager * glob_manager;
 Query_queue * query_queue;
 Plock part_lock_man;
 OptCC occ_man;
+Topology topology;
 #if CC_ALG == VLL
 VLLMan vll_man;
 #endif
 
 bool volatile warmup_finish = false;
+ts_t volatile run_starttime = 0;
 bool volatile enable_thread_mem_pool = false;
 pthread_barrier_t warmup_bar;
 pthread_barrier_t start_bar;
@@ -77,3 +80,5 @@ uint64_t g_max_orderline = uint64_t(1) << 32;
 
 uint64_t g_sub_size = TATP_SUB_SIZE;
 
+uint64_t g_sb_num_accounts = SB_NUM_ACCOUNTS;
+
@@ -116,6 +116,7 @@ class Query_queue;
 class Plock;
 class OptCC;
 class VLLMan;
+class Topology;
 
 typedef uint8_t UInt8;
 typedef int8_t SInt8;
@@ -138,11 +139,14 @@ extern Manager * glob_manager;
 extern Query_queue * query_queue;
 extern Plock part_lock_man;
 extern OptCC occ_man;
+extern Topology topology;
 #if CC_ALG == VLL
 extern VLLMan vll_man;
 #endif
 
 extern bool volatile warmup_finish;
+// start of the warmup or of the measured run.
+extern ts_t volatile run_starttime;
 extern bool volatile enable_thread_mem_pool;
 extern pthread_barrier_t warmup_bar;
 extern pthread_barrier_t start_bar;
@@ -196,6 +200,9 @@ extern uint64_t g_max_orderline;
 // TATP
 extern uint64_t g_sub_size;
 
+// SMALLBANK
+extern uint64_t g_sb_num_accounts;
+
 enum RC { RCOK, Commit, Abort, WAIT, ERROR, FINISH};
 
 /* Thread */
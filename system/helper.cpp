@@ -1,7 +1,10 @@
 #include "global.h"
 #include "helper.h"
 #include "mem_alloc.h"
+#include "topology.h"
 #include "time.h"
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
 
 bool itemid_t::operator==(const itemid_t &other) const {
 	return (type == other.type && location == other.location);
@@ -105,3 +108,33 @@ uint64_t myrand::next() {
 	seed = (seed * 1103515247UL + 12345UL) % (1UL<<63);
 	return (seed / 65537) % RAND_MAX;
 }
+
+void set_affinity(uint64_t thd_id) {
+	cpu_set_t  mask;
+	CPU_ZERO(&mask);
+	CPU_SET(topology.get_cpu(thd_id), &mask);
+	sched_setaffinity(0, sizeof(cpu_set_t), &mask);
+}
+
+int open_dtlb_miss_counter() {
+	struct perf_event_attr attr;
+	memset(&attr, 0, sizeof(attr));
+	attr.size = sizeof(attr);
+	attr.type = PERF_TYPE_HW_CACHE;
+	attr.config = PERF_COUNT_HW_CACHE_DTLB
+		| (PERF_COUNT_HW_CACHE_OP_READ << 8)
+		| (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+	attr.exclude_kernel = 1;
+	attr.exclude_hv = 1;
+	return (int) syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+uint64_t close_perf_counter(int fd) {
+	if (fd < 0)
+		return 0;
+	uint64_t value = 0;
+	if (read(fd, &value, sizeof(value)) != sizeof(value))
+		value = 0;
+	close(fd);
+	return value;
+}
@@ -215,24 +215,11 @@ private:
 	uint64_t seed;
 };
 
-inline void set_affinity(uint64_t thd_id) {
-	cpu_set_t  mask;
-	CPU_ZERO(&mask);
-	CPU_SET(thd_id, &mask);
-	sched_setaffinity(0, sizeof(cpu_set_t), &mask);
-
-	return;
-	/*
-	// TOOD. the following mapping only works for swarm
-	// which has 4-socket, 10 physical core per socket,
-	// 80 threads in total with hyper-threading
-	uint64_t a = thd_id % 40;
-	uint64_t processor_id = a / 10 + (a % 10) * 4;
-	processor_id += (thd_id / 40) * 40;
-
-	cpu_set_t  mask;
-	CPU_ZERO(&mask);
-	CPU_SET(processor_id, &mask);
-	sched_setaffinity(0, sizeof(cpu_set_t), &mask);
-	*/
-}
+// pins the calling thread to the CPU assigned to thd_id by the topology.
+void set_affinity(uint64_t thd_id);
+
+// counts dTLB load misses of the calling thread through perf_event_open().
+// returns -1 if the counter is not available.
+int open_dtlb_miss_counter();
+// reads and closes the counter. returns 0 for fd == -1.
+uint64_t close_perf_counter(int fd);
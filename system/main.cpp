@@ -2,6 +2,8 @@
 #include "ycsb.h"
 #include "tpcc.h"
 #include "tatp.h"
+#include "smallbank.h"
+#include "custom.h"
 #include "test.h"
 #include "thread.h"
 #include "manager.h"
@@ -11,6 +13,7 @@
 #include "occ.h"
 #include "vll.h"
 #include "table.h"
+#include "topology.h"
 #if INDEX_STRUCT == IDX_MICA
 #include "index_mica.h"
 #endif
@@ -26,6 +29,8 @@ void parser(int argc, char* argv[]);
 int main(int argc, char* argv[]) {
   parser(argc, argv);
 
+  topology.init();
+
   // Init workload part 1
   workload* m_wl;
   switch (WORKLOAD) {
@@ -38,6 +43,12 @@ int main(int argc, char* argv[]) {
     case TATP:
       m_wl = new tatp_wl;
       break;
+    case SMALLBANK:
+      m_wl = new smallbank_wl;
+      break;
+    case CUSTOM:
+      m_wl = new custom_wl;
+      break;
     case TEST:
       m_wl = new TestWorkload;
       ((TestWorkload*)m_wl)->tick();
@@ -194,6 +205,7 @@ int main(int argc, char* argv[]) {
       uint64_t vid = i;
       pthread_create(&p_thds[i], NULL, f, (void*)vid);
     }
+    run_starttime = get_server_clock();
     pthread_barrier_wait(&start_bar);
     for (uint32_t i = 0; i < thd_cnt; i++) pthread_join(p_thds[i], NULL);
     printf("WARMUP finished!\n");
@@ -242,14 +254,22 @@ int main(int argc, char* argv[]) {
     uint64_t vid = i;
     pthread_create(&p_thds[i], NULL, f, (void*)vid);
   }
+  run_starttime = get_server_clock();
   pthread_barrier_wait(&start_bar);
   int64_t starttime = get_server_clock();
   for (uint32_t i = 0; i < thd_cnt; i++) pthread_join(p_thds[i], NULL);
   int64_t endtime = get_server_clock();
+  if (WORKLOAD != TEST) query_queue->flush_trace();
+#if WORKLOAD == TPCC && TPCC_CHECK
+  uint64_t violation_cnt = ((tpcc_wl*)m_wl)->check_consistency();
+#endif
 
   if (WORKLOAD != TEST) {
     printf("PASS! SimTime = %ld\n", endtime - starttime);
-    if (STATS_ENABLE) stats.print((double)(endtime - starttime) / 1000000000.);
+    if (STATS_ENABLE) {
+      stats.print((double)(endtime - starttime) / 1000000000.);
+      topology.print();
+    }
   } else {
     ((TestWorkload*)m_wl)->summarize();
   }
@@ -300,6 +320,9 @@ int main(int argc, char* argv[]) {
   printf("LatencyStart\n");
   inter_commit_latency.print(stdout);
   printf("LatencyEnd\n");
+#endif
+#if WORKLOAD == TPCC && TPCC_CHECK
+  if (violation_cnt != 0) return 1;
 #endif
   return 0;
 }
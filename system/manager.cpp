@@ -7,6 +7,11 @@
 void Manager::init() {
 	timestamp = (uint64_t *) mem_allocator.alloc(sizeof(uint64_t), 0);
 	*timestamp = 1;
+	_clock_ts = (ClockTs *) mem_allocator.alloc(sizeof(ClockTs) * g_thread_cnt, 0);
+	for (uint32_t i = 0; i < g_thread_cnt; i++) {
+		_clock_ts[i].clock = 0;
+		_clock_ts[i].cnt = 0;
+	}
 	_last_min_ts_time = 0;
 	_min_ts = 0;
 	_epoch = (uint64_t *) mem_allocator.alloc(sizeof(uint64_t), 0);
@@ -33,8 +38,6 @@ Manager::get_ts(uint64_t thread_id) {
 	assert(false);
 #endif
 
-	if (g_ts_batch_alloc)
-		assert(g_ts_alloc == TS_CAS);
 	uint64_t time;
 	uint64_t starttime = get_sys_clock();
 	switch(g_ts_alloc) {
@@ -44,10 +47,7 @@ Manager::get_ts(uint64_t thread_id) {
 		pthread_mutex_unlock( &ts_mutex );
 		break;
 	case TS_CAS :
-		if (g_ts_batch_alloc)
-			time = ATOM_FETCH_ADD((*timestamp), g_ts_batch_num);
-		else
-			time = ATOM_FETCH_ADD((*timestamp), 1);
+		time = ATOM_FETCH_ADD((*timestamp), 1);
 		break;
 	case TS_HW :
 #ifndef NOGRAPHITE
@@ -57,7 +57,7 @@ Manager::get_ts(uint64_t thread_id) {
 #endif
 		break;
 	case TS_CLOCK :
-		time = get_sys_clock() * g_thread_cnt + thread_id;
+		time = get_clock_ts(thread_id);
 		break;
 	default :
 		assert(false);
@@ -66,6 +66,37 @@ Manager::get_ts(uint64_t thread_id) {
 	return time;
 }
 
+ts_t
+Manager::get_ts_batch(uint64_t thread_id) {
+	assert(g_ts_alloc == TS_CAS);
+	uint64_t starttime = get_sys_clock();
+	ts_t time = ATOM_FETCH_ADD((*timestamp), g_ts_batch_num);
+	INC_STATS(thread_id, time_ts_alloc, get_sys_clock() - starttime);
+	return time;
+}
+
+// The timestamp is the thread's clock followed by the thread id, so
+// timestamps are unique and increase within a thread. get_server_clock()
+// is used since get_sys_clock() returns 0 without TIME_ENABLE.
+ts_t
+Manager::get_clock_ts(uint64_t thread_id) {
+	ClockTs * my = &_clock_ts[thread_id];
+	ts_t clock = get_server_clock();
+	if (++my->cnt % TS_CLOCK_SYNC_INTVL == 0) {
+		// bound the skew to the fastest clock. Only reads other lines.
+		ts_t max_clock = 0;
+		for (uint32_t i = 0; i < g_thread_cnt; i++)
+			if (_clock_ts[i].clock > max_clock)
+				max_clock = _clock_ts[i].clock;
+		if (max_clock > clock + TS_CLOCK_SKEW)
+			clock = max_clock - TS_CLOCK_SKEW;
+	}
+	if (clock <= my->clock)
+		clock = my->clock + 1;
+	my->clock = clock;
+	return clock * g_thread_cnt + thread_id;
+}
+
 ts_t Manager::get_min_ts(uint64_t tid) {
 	uint64_t now = get_sys_clock();
 	uint64_t last_time = _last_min_ts_time;
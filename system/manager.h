@@ -11,6 +11,9 @@ public:
 	void 			init();
 	// returns the next timestamp.
 	ts_t			get_ts(uint64_t thread_id);
+	// [TS_BATCH_ALLOC] reserves g_ts_batch_num consecutive timestamps
+	// and returns the first one.
+	ts_t			get_ts_batch(uint64_t thread_id);
 
 	// For MVCC. To calculate the min active ts in the system
 	void 			add_ts(uint64_t thd_id, ts_t ts);
@@ -33,6 +36,13 @@ private:
 
 	pthread_mutex_t ts_mutex;
 	uint64_t *		timestamp;
+	// [TS_CLOCK] the last clock value used by each thread.
+	struct ClockTs {
+		volatile ts_t 	clock;
+		uint64_t 		cnt;
+	} __attribute__((aligned(CL_SIZE)));
+	ClockTs *		_clock_ts;
+	ts_t 			get_clock_ts(uint64_t thread_id);
 	pthread_mutex_t mutexes[BUCKET_CNT];
 	uint64_t 		hash(row_t * row);
 	ts_t volatile * volatile * volatile all_ts;
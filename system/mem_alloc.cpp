@@ -8,23 +8,48 @@
 #include "mem_alloc.h"
 #include "helper.h"
 #include "global.h"
+#include "topology.h"
 #include <numa.h>
+#include <sys/mman.h>
+
+#ifndef MAP_HUGE_SHIFT
+#define MAP_HUGE_SHIFT 26
+#endif
+
+#if THREAD_ALLOC
+const UInt32 BlockSizes[SizeNum] = {16, 32, 64, 128, 192, 256, 384, 512,
+	768, 1024, 1536, 2048, 3072, 4096, 6144, 8192};
+
+static_assert(THREAD_ARENA_SIZE % MEM_SLAB_SIZE == 0,
+	"THREAD_ARENA_SIZE must be a multiple of MEM_SLAB_SIZE");
+static_assert(sizeof(SlabHeader) <= CL_SIZE, "SlabHeader must fit in a cache line");
+
+// the arena of the calling thread. Created on the first allocation.
+static thread_local Arena * tls_arena = NULL;
+#define MAX_ARENA_CNT 				4096
+#endif
+
+// Large allocations are placed on the NUMA node of the partition.
+static void bind_memory(void * ptr, uint64_t size, uint64_t part_id) {
+  if (size >= 1048576 * 2 && part_id != (uint64_t)-1 && topology.is_numa()) {
+    auto node = topology.get_part_node(part_id);
+    struct bitmask* bm = numa_allocate_nodemask();
+    numa_bitmask_setbit(bm, node);
+    numa_interleave_memory(ptr, size, bm);
+    numa_free_nodemask(bm);
+  }
+}
 
 // Assume the data is strided across the L2 slices, stride granularity
 // is the size of a page
 void mem_alloc::init(uint64_t part_cnt, uint64_t bytes_per_part) {
-  // if (g_thread_cnt < g_init_parallelism)
-  // 	_bucket_cnt = g_init_parallelism * 4 + 1;
-  // else
-  // 	_bucket_cnt = g_thread_cnt * 4 + 1;
-  // pid_arena = new std::pair<pthread_t, int>[_bucket_cnt];
-  // for (int i = 0; i < _bucket_cnt; i ++)
-  // 	pid_arena[i] = std::make_pair(0, 0);
-  //
-  // if (THREAD_ALLOC) {
-  // 	assert( !g_part_alloc );
-  // 	init_thread_arena();
-  // }
+  _huge_bytes = 0;
+  _huge_fallback_bytes = 0;
+#if THREAD_ALLOC
+  assert(!RCU_ALLOC);
+  _arenas = new Arena * [MAX_ARENA_CNT];
+  _arena_cnt = 0;
+#endif
 
   if (RCU_ALLOC) {
     const size_t maxpercpu = util::iceil((RCU_ALLOC_SIZE) / g_thread_cnt,
@@ -45,131 +70,141 @@ void mem_alloc::init(uint64_t part_cnt, uint64_t bytes_per_part) {
   }
 }
 
-// void
-// Arena::init(int arena_id, int size) {
-// 	_buffer = NULL;
-// 	_arena_id = arena_id;
-// 	_size_in_buffer = 0;
-// 	_head = NULL;
-// 	_block_size = size;
-// }
-//
-// void *
-// Arena::alloc() {
-// 	FreeBlock * block;
-// 	if (_head == NULL) {
-// 		// not in the list. allocate from the buffer
-// 		int size = (_block_size + sizeof(FreeBlock) + (MEM_ALLIGN - 1)) & ~(MEM_ALLIGN-1);
-// 		if (_size_in_buffer < size) {
-// 			_buffer = (char *) malloc(_block_size * 40960);
-// 			_size_in_buffer = _block_size * 40960; // * 8;
-// 		}
-// 		block = (FreeBlock *)_buffer;
-// 		block->size = _block_size;
-// 		_size_in_buffer -= size;
-// 		_buffer = _buffer + size;
-// 	} else {
-// 		block = _head;
-// 		_head = _head->next;
-// 	}
-// 	return (void *) ((char *)block + sizeof(FreeBlock));
-// }
-//
-// void
-// Arena::free(void * ptr) {
-// 	FreeBlock * block = (FreeBlock *)((UInt64)ptr - sizeof(FreeBlock));
-// 	block->next = _head;
-// 	_head = block;
-// }
-
-// void mem_alloc::init_thread_arena() {
-// 	UInt32 buf_cnt = g_thread_cnt;
-// 	if (buf_cnt < g_init_parallelism)
-// 		buf_cnt = g_init_parallelism;
-// 	_arenas = new Arena * [buf_cnt];
-// 	for (UInt32 i = 0; i < buf_cnt; i++) {
-// 		_arenas[i] = new Arena[SizeNum];
-// 		for (int n = 0; n < SizeNum; n++) {
-// 			assert(sizeof(Arena) == 128);
-// 			_arenas[i][n].init(i, BlockSizes[n]);
-// 		}
-// 	}
-// }
+#if THREAD_ALLOC
+void
+Arena::init(int arena_id) {
+	_arena_id = arena_id;
+	for (int i = 0; i < SizeNum; i++) {
+		_head[i] = NULL;
+		_bump[i] = NULL;
+		_bump_end[i] = NULL;
+		_remote[i] = NULL;
+		_alloc_cnt[i] = 0;
+		_free_cnt[i] = 0;
+	}
+	_chunk = NULL;
+	_chunk_left = 0;
+	_remote_free_cnt = 0;
+	_slab_cnt = 0;
+	_large_cnt = 0;
+}
+
+void *
+Arena::alloc(int size_id, uint64_t part_id) {
+	FreeBlock * block = _head[size_id];
+	if (block == NULL && _remote[size_id] != NULL) {
+		// take all the blocks freed by other threads at once.
+		block = __sync_lock_test_and_set(&_remote[size_id], NULL);
+	}
+	if (block) {
+		_head[size_id] = block->next;
+	} else {
+		// not in the list. allocate from the current slab
+		if (_bump[size_id] + BlockSizes[size_id] > _bump_end[size_id])
+			new_slab(size_id, part_id);
+		block = (FreeBlock *) _bump[size_id];
+		_bump[size_id] += BlockSizes[size_id];
+	}
+	_alloc_cnt[size_id] ++;
+	return (void *) block;
+}
+
+void
+Arena::free(int size_id, FreeBlock * block) {
+	block->next = _head[size_id];
+	_head[size_id] = block;
+	_free_cnt[size_id] ++;
+}
+
+void
+Arena::remote_free(int size_id, FreeBlock * block) {
+	FreeBlock * head;
+	do {
+		head = _remote[size_id];
+		block->next = head;
+	} while (!ATOM_CAS(_remote[size_id], head, block));
+}
+
+void
+Arena::new_slab(int size_id, uint64_t part_id) {
+	if (_chunk_left < MEM_SLAB_SIZE) {
+		// slabs are carved from a chunk placed on the partition's node.
+#if HUGE_PAGE
+		if (HUGE_PAGE_SIZE <= THREAD_ARENA_SIZE)
+			_chunk = (char *) mem_allocator.alloc_huge(THREAD_ARENA_SIZE, part_id);
+		else
+#endif
+		{
+			_chunk = (char *) _mm_malloc(THREAD_ARENA_SIZE, MEM_SLAB_SIZE);
+			bind_memory(_chunk, THREAD_ARENA_SIZE, part_id);
+		}
+		assert(_chunk != NULL);
+		assert(((uintptr_t)_chunk & (MEM_SLAB_SIZE - 1)) == 0);
+		_chunk_left = THREAD_ARENA_SIZE;
+	}
+	SlabHeader * slab = (SlabHeader *) _chunk;
+	_chunk += MEM_SLAB_SIZE;
+	_chunk_left -= MEM_SLAB_SIZE;
+	slab->size_id = size_id;
+	slab->owner = this;
+	_bump[size_id] = (char *) slab + CL_SIZE;
+	_bump_end[size_id] = (char *) slab + MEM_SLAB_SIZE;
+	_slab_cnt ++;
+}
+
+Arena *
+mem_alloc::get_arena() {
+	if (tls_arena == NULL) {
+		Arena * arena = (Arena *) _mm_malloc(sizeof(Arena), CL_SIZE);
+		uint32_t arena_id = ATOM_FETCH_ADD(_arena_cnt, 1);
+		assert(arena_id < MAX_ARENA_CNT);
+		arena->init(arena_id);
+		_arenas[arena_id] = arena;
+		tls_arena = arena;
+	}
+	return tls_arena;
+}
+
+int
+mem_alloc::get_size_id(uint64_t size) {
+	for (int i = 0; i < SizeNum; i++) {
+		if (size <= BlockSizes[i])
+			return i;
+	}
+	return -1;
+}
+#endif
 
 void mem_alloc::register_thread(int thd_id) {
   if (RCU_ALLOC) rcu::s_instance.pin_current_thread(thd_id);
-
-  // if (THREAD_ALLOC) {
-  // 	pthread_mutex_lock( &map_lock );
-  // 	pthread_t pid = pthread_self();
-  // 	int entry = pid % _bucket_cnt;
-  // 	while (pid_arena[ entry ].first != 0) {
-  // 		printf("conflict at entry %d (pid=%ld)\n", entry, pid);
-  // 		entry = (entry + 1) % _bucket_cnt;
-  // 	}
-  // 	pid_arena[ entry ].first = pid;
-  // 	pid_arena[ entry ].second = thd_id;
-  // 	pthread_mutex_unlock( &map_lock );
-  // }
 }
 
 void mem_alloc::unregister() {
-  // if (THREAD_ALLOC) {
-  // 	pthread_mutex_lock( &map_lock );
-  // 	for (int i = 0; i < _bucket_cnt; i ++) {
-  // 		pid_arena[i].first = 0;
-  // 		pid_arena[i].second = 0;
-  // 	}
-  // 	pthread_mutex_unlock( &map_lock );
-  // }
-}
-
-// int
-// mem_alloc::get_arena_id() {
-// 	int arena_id;
-// #if NOGRAPHITE
-// 	pthread_t pid = pthread_self();
-// 	int entry = pid % _bucket_cnt;
-// 	while (pid_arena[entry].first != pid) {
-// 		if (pid_arena[entry].first == 0)
-// 			break;
-// 		entry = (entry + 1) % _bucket_cnt;
-// 	}
-// 	arena_id = pid_arena[entry].second;
-// #else
-// 	arena_id = CarbonGetTileId();
-// #endif
-// 	return arena_id;
-// }
-//
-// int
-// mem_alloc::get_size_id(UInt32 size) {
-// 	for (int i = 0; i < SizeNum; i++) {
-// 		if (size <= BlockSizes[i])
-// 			return i;
-// 	}
-//     printf("size = %d\n", size);
-// 	assert( false );
-// 	return 0;
-// }
+}
 
 void mem_alloc::free(void* ptr, uint64_t size) {
   // size = (size + CL_SIZE - 1) & ~CL_SIZE;
-  if (RCU_ALLOC)
+  if (RCU_ALLOC) {
     rcu::s_instance.dealloc_rcu(ptr, size);
-  else
-    _mm_free(ptr);
-
-  // if (NO_FREE) {}
-  // else if (THREAD_ALLOC) {
-  // 	int arena_id = get_arena_id();
-  // 	FreeBlock * block = (FreeBlock *)((UInt64)ptr - sizeof(FreeBlock));
-  // 	int size = block->size;
-  // 	int size_id = get_size_id(size);
-  // 	_arenas[arena_id][size_id].free(ptr);
-  // } else {
-  // 	std::free(ptr);
-  // }
+    return;
+  }
+#if THREAD_ALLOC
+  // the size given by the caller is not always accurate (or 0).
+  // the slab header is used instead.
+  if (NO_FREE || ptr == NULL) return;
+  SlabHeader * slab = (SlabHeader *) ((uint64_t)ptr & ~(MEM_SLAB_SIZE - 1));
+  if (slab->size_id < 0)
+    _mm_free(slab);
+  else if (slab->owner == tls_arena)
+    slab->owner->free(slab->size_id, (FreeBlock *) ptr);
+  else {
+    slab->owner->remote_free(slab->size_id, (FreeBlock *) ptr);
+    Arena * arena = get_arena();
+    arena->_remote_free_cnt ++;
+  }
+#else
+  _mm_free(ptr);
+#endif
 }
 
 //TODO the program should not access more than a PAGE
@@ -179,33 +214,114 @@ void mem_alloc::free(void* ptr, uint64_t size) {
 void* mem_alloc::alloc(uint64_t size, uint64_t part_id) {
   void* ptr;
   // size = (size + CL_SIZE - 1) & ~CL_SIZE;
-  if (RCU_ALLOC)
+  if (RCU_ALLOC) {
     ptr = rcu::s_instance.alloc(size);
-  else
-    ptr = _mm_malloc(size, CL_SIZE);
-
-  if (size >= 1048576 * 2 && part_id != (uint64_t)-1) {
-    auto node = part_id % 2;
-    struct bitmask* bm = numa_allocate_nodemask();
-    numa_bitmask_setbit(bm, node);
-    numa_interleave_memory(ptr, size, bm);
-    numa_free_nodemask(bm);
+    bind_memory(ptr, size, part_id);
+    return ptr;
   }
+#if THREAD_ALLOC
+  Arena * arena = get_arena();
+  int size_id = get_size_id(size);
+  if (size_id >= 0)
+    return arena->alloc(size_id, part_id);
+  // a large block gets a slab header of its own in front of it.
+  SlabHeader * slab = (SlabHeader *) _mm_malloc(size + CL_SIZE, MEM_SLAB_SIZE);
+  assert(slab != NULL);
+  slab->size_id = -1;
+  slab->owner = arena;
+  bind_memory(slab, size + CL_SIZE, part_id);
+  arena->_large_cnt ++;
+  ptr = (char *) slab + CL_SIZE;
+#else
+  ptr = _mm_malloc(size, CL_SIZE);
+  bind_memory(ptr, size, part_id);
+#endif
+  return ptr;
+}
 
-  // if (size > BlockSizes[SizeNum - 1])
-  //   ptr = malloc(size);
-  // else if (THREAD_ALLOC && (warmup_finish || enable_thread_mem_pool)) {
-  // 	int arena_id = get_arena_id();
-  // 	int size_id = get_size_id(size);
-  // 	ptr = _arenas[arena_id][size_id].alloc();
-  // } else {
-  // 	ptr = malloc(size);
-  // }
+void* mem_alloc::alloc_huge(uint64_t size, uint64_t part_id) {
+#if HUGE_PAGE
+  // a small array (e.g. the buckets of WAREHOUSE) would waste most of a
+  // reserved page.
+  if (size < HUGE_PAGE_SIZE) return alloc(size, part_id);
+  uint64_t len = (size + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+  int page_shift = __builtin_ctzl(HUGE_PAGE_SIZE);
+  void* ptr = mmap(NULL, len, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB |
+                       (page_shift << MAP_HUGE_SHIFT),
+                   -1, 0);
+  if (ptr != MAP_FAILED) {
+    ATOM_ADD(_huge_bytes, len);
+  } else {
+    // no huge pages reserved (vm.nr_hugepages). ask for THP instead. mmap
+    // only aligns to 4 KB, so map a page more and trim it to HUGE_PAGE_SIZE
+    // alignment, which THP and the slab headers of THREAD_ALLOC need.
+    char* raw = (char*)mmap(NULL, len + HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE,
+                            MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    assert(raw != MAP_FAILED);
+    char* aligned = (char*)(((uintptr_t)raw + HUGE_PAGE_SIZE - 1) &
+                            ~(HUGE_PAGE_SIZE - 1));
+    if (aligned != raw) munmap(raw, aligned - raw);
+    if (aligned + len != raw + len + HUGE_PAGE_SIZE)
+      munmap(aligned + len, raw + HUGE_PAGE_SIZE - aligned);
+    ptr = aligned;
+    madvise(ptr, len, MADV_HUGEPAGE);
+    ATOM_ADD(_huge_fallback_bytes, len);
+  }
+  bind_memory(ptr, len, part_id);
   return ptr;
+#else
+  return alloc(size, part_id);
+#endif
+}
+
+void mem_alloc::free_huge(void* ptr, uint64_t size) {
+#if HUGE_PAGE
+  if (size < HUGE_PAGE_SIZE) {
+    free(ptr, size);
+    return;
+  }
+  uint64_t len = (size + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+  munmap(ptr, len);
+#else
+  free(ptr, size);
+#endif
 }
 
 void mem_alloc::dump_stats() {
   if (RCU_ALLOC) {
     ::allocator::DumpStats();
   }
+  if (HUGE_PAGE) {
+    fprintf(stderr, "huge pages: %.1f MB reserved, %.1f MB transparent fallback\n",
+            (double)_huge_bytes / 1048576, (double)_huge_fallback_bytes / 1048576);
+  }
+#if THREAD_ALLOC
+  uint64_t alloc_cnt[SizeNum] = {0};
+  uint64_t free_cnt[SizeNum] = {0};
+  uint64_t remote_free_cnt = 0;
+  uint64_t slab_cnt = 0;
+  uint64_t large_cnt = 0;
+  uint32_t arena_cnt = _arena_cnt;
+  for (uint32_t i = 0; i < arena_cnt; i++) {
+    Arena * arena = _arenas[i];
+    for (int n = 0; n < SizeNum; n++) {
+      alloc_cnt[n] += arena->_alloc_cnt[n];
+      free_cnt[n] += arena->_free_cnt[n];
+    }
+    remote_free_cnt += arena->_remote_free_cnt;
+    slab_cnt += arena->_slab_cnt;
+    large_cnt += arena->_large_cnt;
+  }
+  fprintf(stderr,
+          "slab allocator: arenas=%" PRIu32 ", slabs=%" PRIu64
+          " (%.1f MB), large=%" PRIu64 ", remote_free=%" PRIu64 "\n",
+          arena_cnt, slab_cnt, (double)(slab_cnt * MEM_SLAB_SIZE) / 1048576,
+          large_cnt, remote_free_cnt);
+  for (int n = 0; n < SizeNum; n++) {
+    if (alloc_cnt[n] == 0) continue;
+    fprintf(stderr, "  size=%5" PRIu32 ": alloc=%" PRIu64 ", local_free=%" PRIu64 "\n",
+            BlockSizes[n], alloc_cnt[n], free_cnt[n]);
+  }
+#endif
 }
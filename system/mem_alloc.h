@@ -2,29 +2,53 @@
 #define _MEM_ALLOC_H_
 
 #include "global.h"
-// #include <map>
-
-// const int SizeNum = 4;
-// const UInt32 BlockSizes[] = {32, 64, 256, 1024};
-//
-// typedef struct free_block {
-//     int size;
-//     struct free_block* next;
-// } FreeBlock;
-
-// class Arena {
-// public:
-// 	void init(int arena_id, int size);
-// 	void * alloc();
-// 	void free(void * ptr);
-// private:
-// 	char * 		_buffer;
-// 	int 		_size_in_buffer;
-// 	int 		_arena_id;
-// 	int 		_block_size;
-// 	FreeBlock * _head;
-// 	char 		_pad[128 - sizeof(int)*3 - sizeof(void *)*2 - 8];
-// };
+
+#if THREAD_ALLOC
+// size classes of the slab allocator. Larger blocks bypass the slabs.
+const int SizeNum = 16;
+extern const UInt32 BlockSizes[SizeNum];
+
+typedef struct free_block {
+    struct free_block* next;
+} FreeBlock;
+
+class Arena;
+
+// The first cache line of every slab. A block finds its slab by masking
+// its address with MEM_SLAB_SIZE.
+struct SlabHeader {
+	int 		size_id;	// -1 for a block larger than all size classes
+	Arena * 	owner;
+};
+
+// Per-thread slabs for all size classes. Only the owner thread allocates
+// and frees locally; other threads return blocks through _remote.
+class Arena {
+public:
+	void 		init(int arena_id);
+	void * 		alloc(int size_id, uint64_t part_id);
+	void 		free(int size_id, FreeBlock * block);
+	void 		remote_free(int size_id, FreeBlock * block);
+
+	int 		_arena_id;
+	uint64_t 	_alloc_cnt[SizeNum];
+	uint64_t 	_free_cnt[SizeNum];
+	uint64_t 	_remote_free_cnt;
+	uint64_t 	_slab_cnt;
+	uint64_t 	_large_cnt;
+private:
+	void 		new_slab(int size_id, uint64_t part_id);
+
+	FreeBlock * _head[SizeNum];
+	char * 		_bump[SizeNum];
+	char * 		_bump_end[SizeNum];
+	char * 		_chunk;
+	uint64_t 	_chunk_left;
+	// written by remote threads. Kept away from the fields above.
+	char 		_pad[CL_SIZE];
+	FreeBlock * volatile _remote[SizeNum];
+} __attribute__((aligned(CL_SIZE)));
+#endif
 
 class mem_alloc {
 public:
@@ -33,17 +57,24 @@ public:
     void unregister();
     void * alloc(uint64_t size, uint64_t part_id);
     void free(void * block, uint64_t size);
-	// int get_arena_id();
+	// [HUGE_PAGE] large arrays that live as long as the table or index.
+	// Without HUGE_PAGE, and for blocks smaller than HUGE_PAGE_SIZE, these
+	// are alloc() and free().
+	void * alloc_huge(uint64_t size, uint64_t part_id);
+	void free_huge(void * block, uint64_t size);
   void dump_stats();
 private:
-  //   void init_thread_arena();
-	// int get_size_id(UInt32 size);
-
-	// each thread has several arenas for different block size
-	// Arena ** _arenas;
-	// int _bucket_cnt;
-  //   std::pair<pthread_t, int>* pid_arena;//                     max_arena_id;
-  //   pthread_mutex_t         map_lock; // only used for pid_to_arena update
+	// bytes mapped with reserved huge pages and with the THP fallback.
+	volatile uint64_t _huge_bytes;
+	volatile uint64_t _huge_fallback_bytes;
+#if THREAD_ALLOC
+	int 		get_size_id(uint64_t size);
+	Arena * 	get_arena();
+
+	// every arena ever created, for dump_stats().
+	Arena ** 	_arenas;
+	volatile uint32_t _arena_cnt;
+#endif
 };
 
 #endif
@@ -46,6 +46,8 @@ void parser(int argc, char * argv[]) {
 	g_params["validation_lock"] = VALIDATION_LOCK;
 	g_params["pre_abort"] = PRE_ABORT;
 	g_params["atomic_timestamp"] = ATOMIC_TIMESTAMP;
+	g_params["trace_file"] = QUERY_TRACE_FILE;
+	g_params["custom_config"] = CUSTOM_CONFIG_FILE;
 
 	for (int i = 1; i < argc; i++) {
 		assert(argv[i][0] == '-');
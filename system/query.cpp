@@ -1,4 +1,5 @@
 #include <sched.h>
+#include <sstream>
 #include "query.h"
 #include "mem_alloc.h"
 #include "wl.h"
@@ -7,6 +8,8 @@
 #include "tpcc_query.h"
 #include "tpcc_helper.h"
 #include "tatp_query.h"
+#include "smallbank_query.h"
+#include "custom_query.h"
 
 /*************************************************/
 //     class Query_queue
@@ -21,12 +24,16 @@ Query_queue::init(workload * h_wl) {
 
 
 #if WORKLOAD == YCSB
-	ycsb_query::calculateDenom();
+	ycsb_query::init_zipf();
 #elif WORKLOAD == TPCC
 	assert(tpcc_buffer != NULL);
 #elif WORKLOAD == TATP
 	// TATP shares tpcc_buffer with TPCC
 	assert(tpcc_buffer != NULL);
+#elif WORKLOAD == SMALLBANK
+	assert(tpcc_buffer != NULL);
+#elif WORKLOAD == CUSTOM
+	assert(tpcc_buffer != NULL);
 #endif
 	int64_t begin = get_server_clock();
 	pthread_t p_thds[g_thread_cnt - 1];
@@ -52,6 +59,19 @@ Query_queue::get_next_query(uint64_t thd_id) {
 	return query;
 }
 
+void
+Query_queue::release_query(uint64_t thd_id, base_query * query) {
+	all_queries[thd_id]->release_query(query);
+}
+
+void
+Query_queue::flush_trace() {
+#if QUERY_TRACE_RECORD
+	for (uint32_t tid = 0; tid < g_thread_cnt; tid ++)
+		all_queries[tid]->trace.flush();
+#endif
+}
+
 void *
 Query_queue::threadInitQuery(void * This) {
 	Query_queue * query_queue = (Query_queue *)This;
@@ -78,8 +98,16 @@ void
 Query_thd::init(workload * h_wl, int thread_id) {
 	uint64_t request_cnt;
 	q_idx = 0;
+#if QUERY_STREAM
+	// a query is held by the thread while it runs or waits in the abort
+	// buffer.
+	request_cnt = ABORT_BUFFER_SIZE + 2;
+	_wl = h_wl;
+	_thd_id = thread_id;
+#else
 	// request_cnt = WARMUP / g_thread_cnt + MAX_TXN_PER_PART + 4;
 	request_cnt = WARMUP + MAX_TXN_PER_PART + ABORT_BUFFER_SIZE * 2;
+#endif
 #if WORKLOAD == YCSB
 	queries = (ycsb_query *)
 		mem_allocator.alloc(sizeof(ycsb_query) * request_cnt, thread_id);
@@ -88,25 +116,79 @@ Query_thd::init(workload * h_wl, int thread_id) {
 	queries = (tpcc_query *) mem_allocator.alloc(sizeof(tpcc_query) * request_cnt, thread_id);
 #elif WORKLOAD == TATP
 	queries = (tatp_query *) mem_allocator.alloc(sizeof(tatp_query) * request_cnt, thread_id);
+#elif WORKLOAD == SMALLBANK
+	queries = (smallbank_query *) mem_allocator.alloc(sizeof(smallbank_query) * request_cnt, thread_id);
+#elif WORKLOAD == CUSTOM
+	queries = (custom_query *) mem_allocator.alloc(sizeof(custom_query) * request_cnt, thread_id);
 #else
 		assert(false);
 #endif
 	for (UInt32 qid = 0; qid < request_cnt; qid ++) {
 #if WORKLOAD == YCSB
 		new(&queries[qid]) ycsb_query();
-		queries[qid].init(thread_id, h_wl, this);
 #elif WORKLOAD == TPCC
 		new(&queries[qid]) tpcc_query();
-		queries[qid].init(thread_id, h_wl);
 #elif WORKLOAD == TATP
 		new(&queries[qid]) tatp_query();
+#elif WORKLOAD == SMALLBANK
+		new(&queries[qid]) smallbank_query();
+#elif WORKLOAD == CUSTOM
+		new(&queries[qid]) custom_query();
+#endif
+#if !QUERY_TRACE_REPLAY || QUERY_STREAM
+		// [QUERY_TRACE] otherwise get_next_query() points the query into the
+		// trace, so there is nothing to allocate or generate.
+#if WORKLOAD == YCSB
+		queries[qid].init(thread_id, h_wl, this);
+#elif WORKLOAD != TEST
 		queries[qid].init(thread_id, h_wl);
+#endif
 #endif
 	}
+#if QUERY_STREAM
+	free_queries = (base_query **)
+		mem_allocator.alloc(sizeof(base_query *) * request_cnt, thread_id);
+	for (UInt32 qid = 0; qid < request_cnt; qid ++)
+		free_queries[qid] = &queries[qid];
+	free_cnt = request_cnt;
+#endif
+#if QUERY_TRACE_RECORD || QUERY_TRACE_REPLAY
+	stringstream path;
+	path << g_params["trace_file"] << "." << thread_id;
+#if QUERY_TRACE_RECORD
+	trace.init_record(path.str().c_str());
+#else
+	trace.init_replay(path.str().c_str());
+#endif
+#endif
 }
 
 base_query *
 Query_thd::get_next_query() {
+#if QUERY_STREAM
+	assert(free_cnt > 0);
+	base_query * query = free_queries[--free_cnt];
+#if QUERY_TRACE_REPLAY
+	query->trace_decode(trace.next());
+#else
+	query->gen(_thd_id, _wl);
+#endif
+	q_idx++;
+#else
 	base_query * query = &queries[q_idx++];
+#if QUERY_TRACE_REPLAY
+	query->trace_decode(trace.next());
+#endif
+#endif
+#if QUERY_TRACE_RECORD
+	trace.record(query);
+#endif
 	return query;
 }
+
+void
+Query_thd::release_query(base_query * query) {
+#if QUERY_STREAM
+	free_queries[free_cnt++] = query;
+#endif
+}
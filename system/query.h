@@ -2,15 +2,26 @@
 
 #include "global.h"
 #include "helper.h"
+#include "query_trace.h"
 
 class workload;
 class ycsb_query;
 class tpcc_query;
 class tatp_query;
+class smallbank_query;
+class custom_query;
 
 class base_query {
 public:
 	virtual void init(uint64_t thd_id, workload * h_wl) = 0;
+	// generate a new query into the buffers allocated by init().
+	virtual void gen(uint64_t thd_id, workload * h_wl) = 0;
+	// [QUERY_TRACE] size of the trace record of the query (a multiple of
+	// 8), and the record itself. trace_decode() points the arrays of the
+	// query into buf.
+	virtual uint32_t trace_size() = 0;
+	virtual void trace_encode(char * buf) = 0;
+	virtual void trace_decode(char * buf) = 0;
 	uint64_t waiting_time;
 	uint64_t part_num;
 	uint64_t * part_to_access;
@@ -25,6 +36,10 @@ class Query_thd {
 public:
 	void init(workload * h_wl, int thread_id);
 	base_query * get_next_query(); 
+	void release_query(base_query * query);
+#if QUERY_TRACE_RECORD || QUERY_TRACE_REPLAY
+	QueryTrace trace;
+#endif
 	int q_idx;
 #if WORKLOAD == YCSB
 	ycsb_query * queries;
@@ -32,9 +47,22 @@ public:
 	tpcc_query * queries;
 #elif WORKLOAD == TATP
 	tatp_query * queries;
+#elif WORKLOAD == SMALLBANK
+	smallbank_query * queries;
+#elif WORKLOAD == CUSTOM
+	custom_query * queries;
 #endif
 	char pad[CL_SIZE - sizeof(void *) - sizeof(int)];
 	drand48_data buffer;
+#if QUERY_STREAM
+private:
+	// [QUERY_STREAM] queries not held by the thread (running or in the
+	// abort buffer).
+	base_query ** free_queries;
+	int free_cnt;
+	workload * _wl;
+	int _thd_id;
+#endif
 };
 
 // TODO we assume a separate task queue for each thread in order to avoid 
@@ -45,6 +73,10 @@ public:
 	void init(workload * h_wl);
 	void init_per_thread(int thread_id);
 	base_query * get_next_query(uint64_t thd_id); 
+	// the thread is done with a committed query.
+	void release_query(uint64_t thd_id, base_query * query);
+	// [QUERY_TRACE_RECORD] write out the buffered records.
+	void flush_trace();
 	
 private:
 	static void * threadInitQuery(void * This);
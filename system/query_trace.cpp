@@ -0,0 +1,79 @@
+#include "query_trace.h"
+#include "query.h"
+#include "mem_alloc.h"
+// after global.h: fcntl.h defines LOCK_EX and LOCK_SH.
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+void
+QueryTrace::init_record(const char * path)
+{
+	_fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	M_ASSERT(_fd >= 0, "cannot create trace file %s\n", path);
+	_buf = (char *) mem_allocator.alloc(BUF_SIZE, -1);
+	Header * header = (Header *) _buf;
+	header->magic = MAGIC;
+	header->workload = WORKLOAD;
+	_buf_pos = sizeof(Header);
+}
+
+void
+QueryTrace::record(base_query * query)
+{
+	uint32_t size = query->trace_size();
+	assert(size % 8 == 0 && sizeof(uint64_t) + size <= BUF_SIZE);
+	if (_buf_pos + sizeof(uint64_t) + size > BUF_SIZE)
+		flush();
+	*(uint64_t *)(_buf + _buf_pos) = size;
+	query->trace_encode(_buf + _buf_pos + sizeof(uint64_t));
+	_buf_pos += sizeof(uint64_t) + size;
+}
+
+void
+QueryTrace::flush()
+{
+	uint32_t pos = 0;
+	while (pos < _buf_pos) {
+		ssize_t ret = write(_fd, _buf + pos, _buf_pos - pos);
+		M_ASSERT(ret > 0, "cannot write the trace file\n");
+		pos += ret;
+	}
+	_buf_pos = 0;
+}
+
+void
+QueryTrace::init_replay(const char * path)
+{
+	_fd = open(path, O_RDONLY);
+	M_ASSERT(_fd >= 0, "cannot open trace file %s\n", path);
+	struct stat st;
+	int ret = fstat(_fd, &st);
+	assert(ret == 0);
+	_size = st.st_size;
+	// a thread that took no query while recording (e.g. a CH thread)
+	// leaves just the header. It fails in next() if it ever needs one.
+	M_ASSERT(_size >= sizeof(Header), "trace file %s is truncated\n", path);
+	// private and writable: a query may modify its arrays in place.
+	// The pages are populated up front, so the run takes no page faults.
+	_map = (char *) mmap(NULL, _size, PROT_READ | PROT_WRITE,
+		MAP_PRIVATE | MAP_POPULATE, _fd, 0);
+	M_ASSERT(_map != MAP_FAILED, "cannot map trace file %s\n", path);
+	Header * header = (Header *) _map;
+	M_ASSERT(header->magic == MAGIC && header->workload == WORKLOAD,
+		"%s is not a trace of this workload\n", path);
+	_pos = sizeof(Header);
+}
+
+char *
+QueryTrace::next()
+{
+	M_ASSERT(_size > sizeof(Header), "the trace file has no queries\n");
+	if (_pos == _size)
+		_pos = sizeof(Header);
+	uint64_t size = *(uint64_t *)(_map + _pos);
+	char * payload = _map + _pos + sizeof(uint64_t);
+	_pos += sizeof(uint64_t) + size;
+	assert(_pos <= _size);
+	return payload;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "global.h"
+
+class base_query;
+
+#if QUERY_TRACE_RECORD && QUERY_TRACE_REPLAY
+#error "QUERY_TRACE_RECORD and QUERY_TRACE_REPLAY are exclusive"
+#endif
+
+// [QUERY_TRACE] per-thread binary trace of the queries handed to a thread.
+// The file is a Header followed by records: a uint64_t size and the
+// payload written by base_query::trace_encode(). Payloads are 8-byte
+// aligned, so a replayed query points its arrays into the mapped file
+// instead of copying them.
+class QueryTrace {
+public:
+	void 		init_record(const char * path);
+	void 		record(base_query * query);
+	void 		flush();
+
+	void 		init_replay(const char * path);
+	// the payload of the next record. The trace is replayed in a loop.
+	char * 		next();
+private:
+	struct Header {
+		uint64_t 	magic;
+		uint64_t 	workload;
+	};
+	static const uint64_t MAGIC = 0x4543415254584244UL; // "DBXTRACE"
+	static const uint32_t BUF_SIZE = 1 << 20;
+
+	int 		_fd;
+	// record
+	char * 		_buf;
+	uint32_t 	_buf_pos;
+	// replay
+	char * 		_map;
+	uint64_t 	_size;
+	uint64_t 	_pos;
+};
+
+// payload helpers. Every field starts at an 8-byte boundary.
+inline uint32_t trace_align(uint64_t size) { return (size + 7) / 8 * 8; }
+
+inline void trace_put(char * buf, uint32_t & pos, const void * src, uint64_t size) {
+	memcpy(buf + pos, src, size);
+	pos += trace_align(size);
+}
+
+inline char * trace_get(char * buf, uint32_t & pos, uint64_t size) {
+	char * p = buf + pos;
+	pos += trace_align(size);
+	return p;
+}
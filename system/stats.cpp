@@ -2,11 +2,18 @@
 #include "helper.h"
 #include "stats.h"
 #include "mem_alloc.h"
+#include "ycsb_query.h"
 
 #define BILLION 1000000000UL
 
+// all_debug1/2 keep the first MAX_TXN_PER_PART txns of the run. With
+// QUERY_STREAM a run can commit more than that.
 void Stats_thd::init(uint64_t thd_id) {
+	all_debug1 = NULL;
+	all_debug2 = NULL;
 	clear();
+	if (!g_prt_lat_distr)
+		return;
 	all_debug1 = (uint64_t *)
 		mem_allocator.alloc(sizeof(uint64_t) * MAX_TXN_PER_PART, thd_id);
 	all_debug2 = (uint64_t *)
@@ -32,7 +39,11 @@ void Stats_thd::clear() {
 	latency = 0;
 	time_query = 0;
 	*/
+	uint64_t * debug1_buf = all_debug1;
+	uint64_t * debug2_buf = all_debug2;
 	memset(this, 0, sizeof(Stats_thd));
+	all_debug1 = debug1_buf;
+	all_debug2 = debug2_buf;
 }
 
 void Stats_tmp::init() {
@@ -85,6 +96,8 @@ void Stats::clear(uint64_t tid) {
 void Stats::add_debug(uint64_t thd_id, uint64_t value, uint32_t select) {
 	if (g_prt_lat_distr && warmup_finish) {
 		uint64_t tnum = _stats[thd_id]->txn_cnt;
+		if (tnum >= MAX_TXN_PER_PART)
+			return;
 		if (select == 1)
 			_stats[thd_id]->all_debug1[tnum] = value;
 		else if (select == 2)
@@ -128,12 +141,20 @@ void Stats::print(double sim_time) {
 	uint64_t total_tpcc_payment_abort = 0;
 	uint64_t total_tpcc_new_order_commit = 0;
 	uint64_t total_tpcc_new_order_abort = 0;
+	uint64_t total_tpcc_new_order_rollback = 0;
 	uint64_t total_tpcc_order_status_commit = 0;
 	uint64_t total_tpcc_order_status_abort = 0;
 	uint64_t total_tpcc_delivery_commit = 0;
 	uint64_t total_tpcc_delivery_abort = 0;
 	uint64_t total_tpcc_stock_level_commit = 0;
 	uint64_t total_tpcc_stock_level_abort = 0;
+	uint64_t total_bb_retire_cnt = 0;
+	uint64_t total_bb_dep_cnt = 0;
+	uint64_t total_bb_cascading_abort_cnt = 0;
+	uint64_t total_dtlb_miss = 0;
+	uint64_t total_cold_row_cnt = 0;
+	uint64_t total_cold_bytes = 0;
+	uint64_t total_cold_raw_bytes = 0;
 	for (uint64_t tid = 0; tid < g_thread_cnt; tid ++) {
 		total_txn_cnt += _stats[tid]->txn_cnt;
 		total_abort_cnt += _stats[tid]->abort_cnt;
@@ -155,12 +176,20 @@ void Stats::print(double sim_time) {
 		total_tpcc_payment_abort += _stats[tid]->tpcc_payment_abort;
 		total_tpcc_new_order_commit += _stats[tid]->tpcc_new_order_commit;
 		total_tpcc_new_order_abort += _stats[tid]->tpcc_new_order_abort;
+		total_tpcc_new_order_rollback += _stats[tid]->tpcc_new_order_rollback;
 		total_tpcc_order_status_commit += _stats[tid]->tpcc_order_status_commit;
 		total_tpcc_order_status_abort += _stats[tid]->tpcc_order_status_abort;
 		total_tpcc_delivery_commit += _stats[tid]->tpcc_delivery_commit;
 		total_tpcc_delivery_abort += _stats[tid]->tpcc_delivery_abort;
 		total_tpcc_stock_level_commit += _stats[tid]->tpcc_stock_level_commit;
 		total_tpcc_stock_level_abort += _stats[tid]->tpcc_stock_level_abort;
+		total_bb_retire_cnt += _stats[tid]->bb_retire_cnt;
+		total_bb_dep_cnt += _stats[tid]->bb_dep_cnt;
+		total_bb_cascading_abort_cnt += _stats[tid]->bb_cascading_abort_cnt;
+		total_dtlb_miss += _stats[tid]->dtlb_miss;
+		total_cold_row_cnt += _stats[tid]->cold_row_cnt;
+		total_cold_bytes += _stats[tid]->cold_bytes;
+		total_cold_raw_bytes += _stats[tid]->cold_raw_bytes;
 
 		printf("[tid=%ld] txn_cnt=%ld,abort_cnt=%ld\n",
 			tid,
@@ -230,14 +259,32 @@ void Stats::print(double sim_time) {
 			total_tpcc_payment_commit, total_tpcc_payment_abort);
 		printf("[summary] new_order    (%7ld, %7ld)\n",
 			total_tpcc_new_order_commit, total_tpcc_new_order_abort);
+		if (TPCC_SPEC)
+			printf("[summary] new_order_rollback=%ld\n", total_tpcc_new_order_rollback);
 		printf("[summary] order_status (%7ld, %7ld)\n",
 		  total_tpcc_order_status_commit, total_tpcc_order_status_abort);
 		printf("[summary] delivery     (%7ld, %7ld)\n",
 			total_tpcc_delivery_commit, total_tpcc_delivery_abort);
 		printf("[summary] stock_level  (%7ld, %7ld)\n",
 			total_tpcc_stock_level_commit, total_tpcc_stock_level_abort);
+		printf("[summary] tpmC=%.0lf\n", total_tpcc_new_order_commit * 60 / sim_time);
+	}
+	if (BAMBOO) {
+		printf("[summary] bamboo retire_cnt=%ld, dep_cnt=%ld, cascading_abort_cnt=%ld\n",
+			total_bb_retire_cnt, total_bb_dep_cnt, total_bb_cascading_abort_cnt);
+	}
+	if (total_dtlb_miss > 0) {
+		printf("[summary] dtlb_miss=%ld, dtlb_miss_per_txn=%f, huge_page=%d\n",
+			total_dtlb_miss, (double)total_dtlb_miss / total_txn_cnt, HUGE_PAGE);
+	}
+	if (total_cold_row_cnt > 0) {
+		printf("[summary] cold_rows=%ld, cold_bytes=%ld, cold_ratio=%f\n",
+			total_cold_row_cnt, total_cold_bytes,
+			(double)total_cold_bytes / total_cold_raw_bytes);
 	}
 	printf("[summary] tput=%.0lf\n", total_txn_cnt / sim_time);
+	print_phases(sim_time);
+	print_ch(sim_time);
 	if (g_prt_lat_distr)
 		print_lat_distr();
 }
@@ -247,14 +294,59 @@ void Stats::print_lat_distr() {
 	if (output_file != NULL) {
 		outf = fopen(output_file, "a");
 		for (UInt32 tid = 0; tid < g_thread_cnt; tid ++) {
+			uint64_t txn_cnt = min(_stats[tid]->txn_cnt, (uint64_t) MAX_TXN_PER_PART);
 			fprintf(outf, "[all_debug1 thd=%d] ", tid);
-			for (uint32_t tnum = 0; tnum < _stats[tid]->txn_cnt; tnum ++)
+			for (uint32_t tnum = 0; tnum < txn_cnt; tnum ++)
 				fprintf(outf, "%ld,", _stats[tid]->all_debug1[tnum]);
 			fprintf(outf, "\n[all_debug2 thd=%d] ", tid);
-			for (uint32_t tnum = 0; tnum < _stats[tid]->txn_cnt; tnum ++)
+			for (uint32_t tnum = 0; tnum < txn_cnt; tnum ++)
 				fprintf(outf, "%ld,", _stats[tid]->all_debug2[tnum]);
 			fprintf(outf, "\n");
 		}
 		fclose(outf);
 	}
 }
+
+void Stats::print_phases(double sim_time) {
+#if WORKLOAD == YCSB && YCSB_PHASE_LEN != 0
+	double phase_len = YCSB_PHASE_LEN / 1000.;
+	for (uint32_t phase = 0; phase < YCSB_MAX_PHASE; phase ++) {
+		double start = phase * phase_len;
+		if (start >= sim_time)
+			break;
+		// the last phase also takes whatever runs past YCSB_MAX_PHASE.
+		double len = (phase == YCSB_MAX_PHASE - 1)? sim_time - start
+			: min(phase_len, sim_time - start);
+		uint64_t txn_cnt = 0;
+		uint64_t abort_cnt = 0;
+		for (uint64_t tid = 0; tid < g_thread_cnt; tid ++) {
+			txn_cnt += _stats[tid]->phase_txn_cnt[phase];
+			abort_cnt += _stats[tid]->phase_abort_cnt[phase];
+		}
+		printf("[phase] id=%d, start=%.3f, burst=%d, txn_cnt=%ld, abort_cnt=%ld"
+			", tput=%.0lf, abort_rate=%f\n",
+			phase, start, ycsb_query::is_burst_phase(phase), txn_cnt, abort_cnt,
+			txn_cnt / len, (double)abort_cnt / max(txn_cnt + abort_cnt, (uint64_t)1));
+	}
+#endif
+}
+
+void Stats::print_ch(double sim_time) {
+#if WORKLOAD == TPCC && CH_OLAP_THREAD_CNT != 0
+	static const char * names[CH_QUERY_CNT] = {"Q1", "Q6", "Q11", "Q14"};
+	for (uint32_t type = 0; type < CH_QUERY_CNT; type ++) {
+		uint64_t query_cnt = 0;
+		uint64_t abort_cnt = 0;
+		uint64_t query_time = 0;
+		for (uint64_t tid = 0; tid < g_thread_cnt; tid ++) {
+			query_cnt += _stats[tid]->ch_query_cnt[type];
+			abort_cnt += _stats[tid]->ch_abort_cnt[type];
+			query_time += _stats[tid]->ch_query_time[type];
+		}
+		printf("[ch] query=%s, query_cnt=%ld, abort_cnt=%ld, qph=%.0lf"
+			", avg_latency_ms=%f\n",
+			names[type], query_cnt, abort_cnt, query_cnt * 3600 / sim_time,
+			(double)query_time / max(query_cnt, (uint64_t)1) / 1000000.);
+	}
+#endif
+}
@@ -31,6 +31,8 @@ public:
 	uint64_t tpcc_payment_abort;
 	uint64_t tpcc_new_order_commit;
 	uint64_t tpcc_new_order_abort;
+	// [TPCC_SPEC] NewOrders rolled back on an unused item.
+	uint64_t tpcc_new_order_rollback;
 	uint64_t tpcc_order_status_commit;
 	uint64_t tpcc_order_status_abort;
 	uint64_t tpcc_delivery_commit;
@@ -38,6 +40,31 @@ public:
 	uint64_t tpcc_stock_level_commit;
 	uint64_t tpcc_stock_level_abort;
 
+	uint64_t bb_retire_cnt;
+	uint64_t bb_dep_cnt;
+	uint64_t bb_cascading_abort_cnt;
+
+	// dTLB load misses during the measured run (see HUGE_PAGE).
+	uint64_t dtlb_miss;
+
+	// [COLD_STORE] rows frozen and the bytes of their blocks / tuples.
+	uint64_t cold_row_cnt;
+	uint64_t cold_bytes;
+	uint64_t cold_raw_bytes;
+
+#if WORKLOAD == YCSB && YCSB_PHASE_LEN != 0
+	// [YCSB_PHASE] commits and aborts per phase of the run.
+	uint64_t phase_txn_cnt[YCSB_MAX_PHASE];
+	uint64_t phase_abort_cnt[YCSB_MAX_PHASE];
+#endif
+#if WORKLOAD == TPCC && CH_OLAP_THREAD_CNT != 0
+	// [CH_BENCH] completed queries, aborted runs and the time from the
+	// first run to the commit (ns) per query type.
+	uint64_t ch_query_cnt[CH_QUERY_CNT];
+	uint64_t ch_abort_cnt[CH_QUERY_CNT];
+	uint64_t ch_query_time[CH_QUERY_CNT];
+#endif
+
 	char _pad[CL_SIZE];
 };
 
@@ -72,5 +99,7 @@ public:
 	void commit(uint64_t thd_id);
 	void abort(uint64_t thd_id);
 	void print(double sim_time);
+	void print_phases(double sim_time);
+	void print_ch(double sim_time);
 	void print_lat_distr();
 };
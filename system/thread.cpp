@@ -16,8 +16,11 @@
 #include "vll.h"
 #include "ycsb_query.h"
 #include "tpcc_query.h"
+#include "tpcc.h"
 #include "mem_alloc.h"
 #include "test.h"
+#include "table.h"
+#include "cold_store.h"
 
 #if CC_ALG == MICA || MICA_USE_FIXED_BACKOFF
 
@@ -37,6 +40,8 @@ void thread_t::init(uint64_t thd_id, workload * workload) {
 		_abort_buffer[i].query = NULL;
 	_abort_buffer_empty_slots = _abort_buffer_size;
 	_abort_buffer_enable = (g_params["abort_buffer_enable"] == "true");
+	_curr_ts = 0;
+	_ts_batch_end = 0;
 }
 
 uint64_t thread_t::get_thd_id() { return _thd_id; }
@@ -73,6 +78,7 @@ RC thread_t::run() {
 	// }
 
 	pthread_barrier_wait( &start_bar );
+	int dtlb_fd = open_dtlb_miss_counter();
 
 	myrand rdm;
 	rdm.init(get_thd_id());
@@ -90,6 +96,14 @@ RC thread_t::run() {
   ts_t last_commit_time = 0;
 #endif
 
+#if WORKLOAD == TPCC && CH_OLAP_THREAD_CNT != 0
+	if (get_thd_id() >= g_thread_cnt - CH_OLAP_THREAD_CNT) {
+		rc = run_olap(m_txn, thd_txn_id);
+		close_perf_counter(dtlb_fd);
+		return rc;
+	}
+#endif
+
 	uint64_t exp_endtime;
 	if (!warmup_finish)
 	  exp_endtime = get_server_clock() + static_cast<uint64_t>(MAX_WARMUP_DURATION * 1000000000.);
@@ -149,7 +163,8 @@ RC thread_t::run() {
 		if ((CC_ALG == HSTORE && !HSTORE_LOCAL_TS)
 				|| CC_ALG == MVCC
 				|| CC_ALG == HEKATON
-				|| CC_ALG == TIMESTAMP)
+				|| CC_ALG == TIMESTAMP
+				|| (BAMBOO && (CC_ALG == WAIT_DIE || CC_ALG == NO_WAIT)))
 			m_txn->set_ts(get_next_ts());
 
 		rc = RCOK;
@@ -236,6 +251,7 @@ RC thread_t::run() {
 		if (++m_query->sub_query_id != m_query->max_sub_query_id)
 			continue;
 #endif
+		query_queue->release_query(_thd_id, m_query);
 		m_query = nullptr;
 	}
 #endif
@@ -262,8 +278,19 @@ RC thread_t::run() {
 		//stats.add_lat(get_thd_id(), timespan);
 		if (rc == RCOK) {
 			INC_STATS(get_thd_id(), txn_cnt, 1);
+#if WORKLOAD == YCSB && YCSB_PHASE_LEN != 0
+			INC_STATS(get_thd_id(), phase_txn_cnt[ycsb_query::get_phase()], 1);
+#endif
 			stats.commit(get_thd_id());
 			txn_cnt ++;
+#ifndef DISABLE_BUILTIN_BACKOFF
+			if (m_query != NULL)
+				query_queue->release_query(_thd_id, m_query);
+#endif
+#if COLD_STORE
+			if (txn_cnt % COLD_COMPACT_INTVL == 0)
+				compact_cold(m_txn, thd_txn_id);
+#endif
 
 #if CC_ALG != MICA
       ts_t now = get_server_clock();
@@ -275,6 +302,9 @@ RC thread_t::run() {
 		} else if (rc == Abort) {
 			// INC_STATS(get_thd_id(), time_abort, timespan);
 			INC_STATS(get_thd_id(), abort_cnt, 1);
+#if WORKLOAD == YCSB && YCSB_PHASE_LEN != 0
+			INC_STATS(get_thd_id(), phase_abort_cnt[ycsb_query::get_phase()], 1);
+#endif
 			stats.abort(get_thd_id());
 			m_txn->abort_cnt ++;
 		}
@@ -283,24 +313,28 @@ RC thread_t::run() {
 #if CC_ALG == MICA
     	_wl->mica_db->deactivate(static_cast<uint16_t>(get_thd_id()));
 #endif
+			close_perf_counter(dtlb_fd);
 			return rc;
     }
 		// if (!warmup_finish && txn_cnt >= WARMUP / g_thread_cnt)
 		if (!warmup_finish && (txn_cnt >= WARMUP || static_cast<int64_t>(exp_endtime - get_server_clock()) <= 0))
 		{
 			stats.clear( get_thd_id() );
+			close_perf_counter(dtlb_fd);
 #if CC_ALG == MICA
     	_wl->mica_db->deactivate(static_cast<uint16_t>(get_thd_id()));
 #endif
 			return FINISH;
 		}
 
-		if (warmup_finish && (txn_cnt >= MAX_TXN_PER_PART || static_cast<int64_t>(exp_endtime - get_server_clock()) <= 0)) {
+		// [QUERY_STREAM] queries are not used up, so only the time ends the run.
+		if (warmup_finish && ((!QUERY_STREAM && txn_cnt >= MAX_TXN_PER_PART) || static_cast<int64_t>(exp_endtime - get_server_clock()) <= 0)) {
 			// assert(txn_cnt == MAX_TXN_PER_PART);
 	        if( !ATOM_CAS(_wl->sim_done, false, true) )
 				assert( _wl->sim_done);
 	    }
 	    if (_wl->sim_done) {
+			INC_STATS(get_thd_id(), dtlb_miss, close_perf_counter(dtlb_fd));
 #if CC_ALG == MICA
         	_wl->mica_db->deactivate(static_cast<uint16_t>(get_thd_id()));
 #endif
@@ -310,6 +344,90 @@ RC thread_t::run() {
 	assert(false);
 }
 
+#if COLD_STORE
+void
+thread_t::compact_cold(txn_man * m_txn, uint64_t & thd_txn_id) {
+	for (auto it : _wl->tables) {
+		table_t * table = it.second;
+		if (table->cold == NULL)
+			continue;
+		// each partition is compacted by a single thread.
+		for (uint64_t part_id = get_thd_id(); part_id < table->get_part_cnt();
+				part_id += g_thread_cnt) {
+			m_txn->abort_cnt = 0;
+			m_txn->set_txn_id(get_thd_id() + thd_txn_id * g_thread_cnt);
+			thd_txn_id ++;
+			if (CC_ALG == MVCC
+					|| CC_ALG == HEKATON
+					|| CC_ALG == TIMESTAMP
+					|| (BAMBOO && (CC_ALG == WAIT_DIE || CC_ALG == NO_WAIT)))
+				m_txn->set_ts(get_next_ts());
+#if CC_ALG == MVCC || CC_ALG == HEKATON
+			glob_manager->add_ts(get_thd_id(), m_txn->get_ts());
+#elif CC_ALG == OCC
+			m_txn->start_ts = get_next_ts();
+#endif
+			scoped_rcu_region guard;
+			table->cold->compact(m_txn, part_id);
+		}
+	}
+}
+#endif
+
+#if WORKLOAD == TPCC && CH_OLAP_THREAD_CNT != 0
+RC
+thread_t::run_olap(txn_man * m_txn, uint64_t & thd_txn_id) {
+	assert(CH_OLAP_THREAD_CNT < g_thread_cnt);
+	// only the main run is measured.
+	if (!warmup_finish) {
+		stats.clear(get_thd_id());
+		return FINISH;
+	}
+#if CC_ALG == HSTORE
+	uint64_t part_to_access[g_part_cnt];
+	for (uint64_t part_id = 0; part_id < g_part_cnt; part_id++)
+		part_to_access[part_id] = part_id;
+#endif
+	uint32_t type = get_thd_id() % CH_QUERY_CNT;
+	while (!_wl->sim_done) {
+		ts_t starttime = get_server_clock();
+		RC rc;
+		// a query is retried until it commits.
+		do {
+			m_txn->abort_cnt = 0;
+			m_txn->set_txn_id(get_thd_id() + thd_txn_id * g_thread_cnt);
+			thd_txn_id ++;
+			if ((CC_ALG == HSTORE && !HSTORE_LOCAL_TS)
+					|| CC_ALG == HEKATON
+					|| (BAMBOO && (CC_ALG == WAIT_DIE || CC_ALG == NO_WAIT)))
+				m_txn->set_ts(get_next_ts());
+#if CC_ALG == HEKATON
+			glob_manager->add_ts(get_thd_id(), m_txn->get_ts());
+#endif
+			rc = RCOK;
+#if CC_ALG == HSTORE
+			rc = part_lock_man.lock(m_txn, part_to_access, g_part_cnt);
+#endif
+			if (rc == RCOK) {
+				scoped_rcu_region guard;
+				rc = ((tpcc_txn_man *) m_txn)->run_ch_query((CHQueryType) type);
+#if CC_ALG == HSTORE
+				part_lock_man.unlock(m_txn, part_to_access, g_part_cnt);
+#endif
+			}
+			// a scan cut short by the end of the run is not an abort.
+			if (rc == Abort && !_wl->sim_done)
+				INC_STATS(get_thd_id(), ch_abort_cnt[type], 1);
+		} while (rc == Abort && !_wl->sim_done);
+		if (rc == RCOK) {
+			INC_STATS(get_thd_id(), ch_query_cnt[type], 1);
+			INC_STATS(get_thd_id(), ch_query_time[type], get_server_clock() - starttime);
+		}
+		type = (type + 1) % CH_QUERY_CNT;
+	}
+	return FINISH;
+}
+#endif
 
 ts_t
 thread_t::get_next_ts() {
@@ -318,19 +436,29 @@ thread_t::get_next_ts() {
 	assert(false);
 #endif
 	if (g_ts_batch_alloc) {
-		if (_curr_ts % g_ts_batch_num == 0) {
-			_curr_ts = glob_manager->get_ts(get_thd_id());
-			_curr_ts ++;
-		} else {
-			_curr_ts ++;
+		if (_curr_ts == _ts_batch_end) {
+			_curr_ts = glob_manager->get_ts_batch(get_thd_id());
+			_ts_batch_end = _curr_ts + g_ts_batch_num;
 		}
-		return _curr_ts - 1;
+		return _curr_ts ++;
 	} else {
 		_curr_ts = glob_manager->get_ts(get_thd_id());
 		return _curr_ts;
 	}
 }
 
+// A commit timestamp must be above every timestamp handed out so far, so
+// it cannot come from the current batch. It starts a new batch instead,
+// and the begin timestamps that follow stay above the thread's own commit.
+ts_t
+thread_t::get_commit_ts() {
+	if (!g_ts_batch_alloc)
+		return glob_manager->get_ts(get_thd_id());
+	_curr_ts = glob_manager->get_ts_batch(get_thd_id());
+	_ts_batch_end = _curr_ts + g_ts_batch_num;
+	return _curr_ts ++;
+}
+
 RC thread_t::runTest(txn_man * txn)
 {
 	RC rc = RCOK;
@@ -19,6 +19,8 @@ public:
 	void 		set_cur_cid(uint64_t cid);
 
 	void 		init(uint64_t thd_id, workload * workload);
+	// [TS_BATCH_ALLOC] commit timestamps open a new batch.
+	ts_t 		get_commit_ts();
 	// the following function must be in the form void* (*)(void*)
 	// to run with pthread.
 	// conversion is done within the function.
@@ -29,9 +31,19 @@ private:
 	uint64_t 	_host_cid;
 	uint64_t 	_cur_cid;
 	ts_t 		_curr_ts;
+	// [TS_BATCH_ALLOC] _curr_ts up to _ts_batch_end are reserved.
+	ts_t 		_ts_batch_end;
 	ts_t 		get_next_ts();
 
 	RC	 		runTest(txn_man * txn);
+#if COLD_STORE
+	// [COLD_STORE] freeze cold rows of the partitions this thread owns.
+	void 		compact_cold(txn_man * m_txn, uint64_t & thd_txn_id);
+#endif
+#if WORKLOAD == TPCC && CH_OLAP_THREAD_CNT != 0
+	// [CH_BENCH] run the analytical queries until the OLTP threads finish.
+	RC 			run_olap(txn_man * m_txn, uint64_t & thd_txn_id);
+#endif
 	drand48_data buffer;
 
 	// A restart buffer for aborted txns.
@@ -0,0 +1,89 @@
+#include "topology.h"
+#include <algorithm>
+#include <numa.h>
+#include <sched.h>
+
+int
+Topology::read_sysfs(uint32_t cpu, const char * name, int default_val) {
+	char path[128];
+	snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%u/topology/%s", cpu, name);
+	FILE * f = fopen(path, "r");
+	if (f == NULL)
+		return default_val;
+	int val = default_val;
+	if (fscanf(f, "%d", &val) != 1)
+		val = default_val;
+	fclose(f);
+	return val;
+}
+
+void
+Topology::init() {
+	_numa = (numa_available() >= 0);
+	_node_cnt = _numa ? numa_max_node() + 1 : 1;
+
+	// only the CPUs this process may run on.
+	cpu_set_t mask;
+	CPU_ZERO(&mask);
+	sched_getaffinity(0, sizeof(cpu_set_t), &mask);
+	_cpus.clear();
+	for (uint32_t cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+		if (!CPU_ISSET(cpu, &mask))
+			continue;
+		CpuInfo info;
+		info.cpu = cpu;
+		info.socket = read_sysfs(cpu, "physical_package_id", 0);
+		info.core = read_sysfs(cpu, "core_id", cpu);
+		info.node = _numa ? numa_node_of_cpu(cpu) : info.socket;
+		if (info.node < 0)
+			info.node = 0;
+		// CPUs are visited in id order. Earlier siblings of the core come first.
+		info.smt = 0;
+		for (auto & other : _cpus)
+			if (other.socket == info.socket && other.core == info.core)
+				info.smt ++;
+		_cpus.push_back(info);
+	}
+	assert(_cpus.size() > 0);
+
+	std::stable_sort(_cpus.begin(), _cpus.end(),
+		[](const CpuInfo & a, const CpuInfo & b) {
+			if (a.smt != b.smt) return a.smt < b.smt;
+			if (a.node != b.node) return a.node < b.node;
+			if (a.socket != b.socket) return a.socket < b.socket;
+			return a.core < b.core;
+		});
+
+	std::set<int> sockets;
+	for (auto & info : _cpus)
+		sockets.insert(info.socket);
+	_socket_cnt = sockets.size();
+}
+
+void
+Topology::print() {
+	printf("topology: %zu CPUs, %u sockets, %u NUMA nodes%s\n",
+		_cpus.size(), _socket_cnt, _node_cnt, _numa ? "" : " (libnuma unavailable)");
+	if (g_thread_cnt > _cpus.size())
+		printf("topology: %u threads share %zu CPUs\n", g_thread_cnt, _cpus.size());
+}
+
+// Before init() (or without sysfs), thread i runs on CPU i as before.
+uint32_t
+Topology::get_cpu(uint64_t thd_id) {
+	if (_cpus.empty())
+		return thd_id;
+	return _cpus[thd_id % _cpus.size()].cpu;
+}
+
+int
+Topology::get_node(uint64_t thd_id) {
+	if (_cpus.empty())
+		return 0;
+	return _cpus[thd_id % _cpus.size()].node;
+}
+
+int
+Topology::get_part_node(uint64_t part_id) {
+	return get_node(part_id % g_thread_cnt);
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "global.h"
+
+// CPU and NUMA layout of the machine, discovered from sysfs and libnuma.
+// Worker threads fill the physical cores of one node before moving on to
+// the next node. SMT siblings are used only after every physical core.
+// Partition p belongs to worker p % g_thread_cnt, so its rows, index
+// buckets and queries are placed on the node of that worker.
+class Topology {
+public:
+	void 		init();
+	void 		print();
+	uint32_t 	get_cpu(uint64_t thd_id);
+	int 		get_node(uint64_t thd_id);
+	int 		get_part_node(uint64_t part_id);
+	uint32_t 	get_node_cnt() { return _node_cnt; }
+	bool 		is_numa() { return _numa; }
+private:
+	struct CpuInfo {
+		uint32_t 	cpu;
+		int 		node;
+		int 		socket;
+		int 		core;
+		int 		smt;	// 0 for the first hardware thread of a core
+	};
+	static int 	read_sysfs(uint32_t cpu, const char * name, int default_val);
+
+	// in the order worker threads are assigned to them.
+	std::vector<CpuInfo> _cpus;
+	uint32_t 	_node_cnt;
+	uint32_t 	_socket_cnt;
+	bool 		_numa;
+};
@@ -19,12 +19,27 @@
 #include "index_mbtree.h"
 #include "index_mica.h"
 #include "index_mica_mbtree.h"
+#include "cold_store.h"
 
 void txn_man::init(thread_t * h_thd, workload * h_wl, uint64_t thd_id) {
 	this->h_thd = h_thd;
 	this->h_wl = h_wl;
 	pthread_mutex_init(&txn_lock, NULL);
-	lock_ready = false;
+#if CC_ALG == DL_DETECT || CC_ALG == NO_WAIT || CC_ALG == WAIT_DIE
+	// a txn holds at most one entry per accessed or inserted row.
+	lock_entries = (LockEntry *)
+		mem_allocator.alloc(sizeof(LockEntry) * MAX_ROW_PER_TXN * 2, thd_id);
+	free_lock_entries = NULL;
+	for (int i = MAX_ROW_PER_TXN * 2 - 1; i >= 0; i--) {
+		LockEntry * entry = &lock_entries[i];
+		STACK_PUSH(free_lock_entries, entry);
+	}
+	wait_entry = NULL;
+#endif
+#if BAMBOO
+	commit_semaphore = 0;
+	bb_abort = false;
+#endif
 	ready_part = 0;
 	row_cnt = 0;
 	wr_cnt = 0;
@@ -37,7 +52,17 @@ void txn_man::init(thread_t * h_thd, workload * h_wl, uint64_t thd_id) {
 	for (int i = 0; i < MAX_ROW_PER_TXN; i++)
 		accesses[i] = NULL;
 	num_accesses_alloc = 0;
+#if COLD_STORE
+	cold_rows = (row_t **) mem_allocator.alloc(sizeof(row_t *) * MAX_ROW_PER_TXN, thd_id);
+	for (int i = 0; i < MAX_ROW_PER_TXN; i++)
+		cold_rows[i] = NULL;
+	cold_cnt = 0;
+#endif
 #if CC_ALG == TICTOC || CC_ALG == SILO
+#if MOCC
+	last_locked = false;
+	mocc_lock_cnt = 0;
+#endif
 	_pre_abort = (g_params["pre_abort"] == "true");
 	if (g_params["validation_lock"] == "no-wait")
 		_validation_no_wait = true;
@@ -88,6 +113,14 @@ RC txn_man::apply_index_changes(RC rc) {
   assert(rcu::s_instance.in_rcu_region());
 #endif
 
+#if ROW_HEAP && CC_ALG != MICA
+  // new rows become visible to scans. They stay locked until the commit is
+  // done, and cleanup() hides them again on abort.
+  if (rc == RCOK)
+    for (UInt32 i = 0; i < insert_cnt; i++)
+      insert_rows[i]->is_deleted = 0;
+#endif
+
 #if INDEX_STRUCT != IDX_MICA || (INDEX_STRUCT == IDX_MICA && defined(IDX_MICA_USE_MBTREE))
 
 #if !SIMPLE_INDEX_UPDATE
@@ -175,7 +208,14 @@ RC txn_man::apply_index_changes(RC rc) {
 		// printf("remove_row row_id=%" PRIu64 " part_id=%" PRIu64 "\n", row->get_row_id(), row->get_part_id());
 		// XXX: Freeing the row immediately is unsafe due to concurrent access.
 		// We do this only when using RCU.
+#if ROW_HEAP
+#if CC_ALG != HEKATON && CC_ALG != MVCC
+		// RCU delays the reuse of the slot past the current readers.
+		row->get_table()->delete_row(row);
+#endif
+#else
 	  if (RCU_ALLOC) mem_allocator.free(row, row_t::alloc_size(row->get_table()));
+#endif
 		// XXX: We need to perform the following to free up all the resources
 // #if CC_ALG != HSTORE && CC_ALG != OCC && CC_ALG != MICA && !defined(USE_INLINED_DATA)
 // 			// XXX: Need to find the manager size.
@@ -190,6 +230,9 @@ RC txn_man::apply_index_changes(RC rc) {
 }
 
 void txn_man::cleanup(RC rc) {
+#if COLD_STORE
+	cold_cnt = 0;
+#endif
 #if CC_ALG == HEKATON || CC_ALG == MICA
 #if CC_ALG == HEKATON
 	if (rc == Abort) {
@@ -204,7 +247,7 @@ void txn_man::cleanup(RC rc) {
 #endif
       // We cannot free data for Hekaton because of pending reads.
 			//row->free_row();
-			mem_allocator.free(row, row_t::alloc_size(row->get_table()));
+			row->get_table()->delete_row(row);
     }
   }
 #endif
@@ -244,8 +287,18 @@ void txn_man::cleanup(RC rc) {
 		}
 #if CC_ALG != TICTOC && CC_ALG != SILO && CC_ALG != MICA
 		accesses[rid]->data = NULL;
+#endif
+#if (CC_ALG == TICTOC || CC_ALG == SILO) && MOCC
+		// hot locks still held after validation (i.e., on abort).
+		if (accesses[rid]->locked) {
+			orig_r->manager->release();
+			accesses[rid]->locked = false;
+		}
 #endif
 	}
+#if (CC_ALG == TICTOC || CC_ALG == SILO) && MOCC
+	mocc_lock_cnt = 0;
+#endif
 
 	if (rc == Abort) {
 		for (UInt32 i = 0; i < insert_cnt; i ++) {
@@ -271,7 +324,7 @@ void txn_man::cleanup(RC rc) {
 			mem_allocator.free(row->manager, 0);
 #endif
 			row->free_row();
-			mem_allocator.free(row, row_t::alloc_size(row->get_table()));
+			row->get_table()->delete_row(row);
 		}
 	} else {
 		for (UInt32 i = 0; i < insert_cnt; i ++) {
@@ -301,6 +354,27 @@ void txn_man::cleanup(RC rc) {
 #if CC_ALG == DL_DETECT
 	dl_detector.clear_dep(get_txn_id());
 #endif
+#if BAMBOO
+	// all the lock entries are released. no one can touch these anymore.
+	if (rc == Abort && bb_abort)
+		INC_STATS(get_thd_id(), bb_cascading_abort_cnt, 1);
+	commit_semaphore = 0;
+	bb_abort = false;
+#endif
+#endif
+}
+
+void txn_man::retire_row(row_t * row) {
+#if BAMBOO
+	for (int rid = row_cnt - 1; rid >= 0; rid --) {
+		if (accesses[rid]->data != row)
+			continue;
+		if (accesses[rid]->type == WR)
+			accesses[rid]->orig_row->manager->lock_retire(this);
+		return;
+	}
+#else
+	(void)row;
 #endif
 }
 
@@ -342,6 +416,10 @@ row_t* txn_man::get_row(IndexT* index, row_t* row, int part_id, access_t type, c
 #if TPCC_CF
         assert(cf_access_type == NULL);
 #endif
+#if COLD_STORE
+	if (is_cold_ref(row))
+		return get_cold_row(row, type);
+#endif
 
 	if (type == PEEK)
 		return row;
@@ -351,6 +429,9 @@ row_t* txn_man::get_row(IndexT* index, row_t* row, int part_id, access_t type, c
 
 	// uint64_t starttime = get_sys_clock();
 	RC rc = RCOK;
+	// e.g. a serializable scan of a large table. The txn aborts.
+	if (row_cnt >= MAX_ROW_PER_TXN)
+		return NULL;
 	if (accesses[row_cnt] == NULL) {
 		Access * access = (Access *) mem_allocator.alloc(sizeof(Access), -1);
 		accesses[row_cnt] = access;
@@ -366,6 +447,16 @@ row_t* txn_man::get_row(IndexT* index, row_t* row, int part_id, access_t type, c
 		num_accesses_alloc ++;
 	}
 
+#if (CC_ALG == TICTOC || CC_ALG == SILO) && MOCC
+	// [MOCC] the row is locked by this txn itself; only a write takes a hot
+	// lock, so its local copy is the one to use again.
+	if (mocc_lock_cnt > 0) {
+		for (int rid = 0; rid < row_cnt; rid ++)
+			if (accesses[rid]->locked && accesses[rid]->orig_row == row)
+				return accesses[rid]->data;
+	}
+#endif
+
 	// Initial deleted row detection to reduce creating a new local row.
 	if (row->is_deleted)
 		return NULL;
@@ -378,8 +469,15 @@ row_t* txn_man::get_row(IndexT* index, row_t* row, int part_id, access_t type, c
 
 	// Check if the original row is deleted after getting the local row.
 	// This avoids a race condition so that we can simply use the version check for Silo/TicToc to detect any deletion perfomed by another thread.
-	if (row->is_deleted)
+	if (row->is_deleted) {
+#if (CC_ALG == TICTOC || CC_ALG == SILO) && MOCC
+		if (last_locked) {
+			row->manager->release();
+			mocc_lock_cnt --;
+		}
+#endif
 		return NULL;
+	}
 
 	accesses[row_cnt]->type = type;
 	accesses[row_cnt]->orig_row = row;
@@ -391,6 +489,9 @@ row_t* txn_man::get_row(IndexT* index, row_t* row, int part_id, access_t type, c
 #elif CC_ALG == HEKATON
 	accesses[row_cnt]->history_entry = history_entry;
 #endif
+#if (CC_ALG == TICTOC || CC_ALG == SILO) && MOCC
+	accesses[row_cnt]->locked = last_locked;
+#endif
 
 #if ROLL_BACK && (CC_ALG == DL_DETECT || CC_ALG == NO_WAIT || CC_ALG == WAIT_DIE)
 	if (type == WR) {
@@ -480,11 +581,53 @@ row_t* txn_man::search(IndexT* index, uint64_t key, int part_id,
 }
 #endif
 
+#if COLD_STORE
+row_t * txn_man::get_cold_row(row_t * ref, access_t type) {
+	assert(type == RD || type == SCAN || type == PEEK);
+	// the txn aborts, as in get_row().
+	if (cold_cnt >= MAX_ROW_PER_TXN)
+		return NULL;
+	ColdBlock * block = cold_ref_block(ref);
+	// frozen by a compaction that aborted. The index points to the hot row
+	// again.
+	if (!block->wait_commit())
+		return NULL;
+	if (cold_rows[cold_cnt] == NULL) {
+		cold_rows[cold_cnt] = (row_t *) mem_allocator.alloc(row_t::max_alloc_size(), -1);
+		cold_rows[cold_cnt]->init(MAX_TUPLE_SIZE);
+	}
+	row_t * row = cold_rows[cold_cnt ++];
+	row->table = block->table;
+	block->decode(cold_ref_slot(ref), row->get_data());
+	return row;
+}
+#endif
+
+void txn_man::drop_last_read(int prev_row_cnt) {
+	if (row_cnt == prev_row_cnt)
+		return;
+	assert(row_cnt == prev_row_cnt + 1);
+	Access * access = accesses[row_cnt - 1];
+	assert(access->type == RD);
+#if CC_ALG == DL_DETECT || CC_ALG == NO_WAIT || CC_ALG == WAIT_DIE
+#if !((CC_ALG == NO_WAIT || CC_ALG == DL_DETECT) && ISOLATION_LEVEL == REPEATABLE_READ)
+	access->orig_row->return_row(RD, this, access->data);
+#endif
+#elif CC_ALG == SILO || CC_ALG == TICTOC || CC_ALG == HEKATON
+	// nothing is held for a read. The read is just not validated.
+	(void)access;
+#else
+	// the read leaves state (timestamps, copies) in the row manager.
+	assert(false);
+#endif
+	row_cnt --;
+}
+
 // insert_row/remove_row
 bool txn_man::insert_row(table_t* tbl, row_t*& row, int part_id,
                           uint64_t& out_row_id) {
 #if CC_ALG != MICA
-  if (tbl->get_new_row(row, part_id, out_row_id) != RCOK) return false;
+  if (tbl->get_new_row(row, part_id, out_row_id, false) != RCOK) return false;
 	assert(insert_cnt < MAX_ROW_PER_TXN);
 	insert_rows[insert_cnt ++] = row;
 
@@ -728,6 +871,22 @@ RC txn_man::finish(RC rc) {
     assert(false);
   cleanup(rc);
 #else
+#if BAMBOO
+	// wait for the retired txns whose dirty data this txn accessed to commit.
+	if (rc == RCOK && commit_semaphore > 0) {
+		uint64_t starttime = get_server_clock();
+		while (commit_semaphore > 0 && !bb_abort) {
+			// a lock wait may close a cycle with commit dependencies.
+			if (get_server_clock() - starttime > g_timeout)
+				break;
+			PAUSE
+		}
+		if (commit_semaphore > 0)
+			rc = Abort;
+	}
+	if (bb_abort)
+		rc = Abort;
+#endif
 	rc = apply_index_changes(rc);
 	cleanup(rc);
 #endif
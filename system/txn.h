@@ -13,6 +13,7 @@ class INDEX;
 class ARRAY_INDEX;
 class ORDERED_INDEX;
 class IndexMBTree;
+struct LockEntry;
 
 // each thread has a txn_man.
 // a txn_man corresponds to a single transaction.
@@ -40,6 +41,10 @@ public:
 #elif CC_ALG == HEKATON
 	void * 		history_entry;
 #endif
+#if (CC_ALG == TICTOC || CC_ALG == SILO) && MOCC
+	// the row was locked at access time because it was hot.
+	bool 		locked;
+#endif
 
 };
 
@@ -68,14 +73,27 @@ public:
 	void * volatile history_entry;
 #endif
 	// [DL_DETECT, NO_WAIT, WAIT_DIE]
-	bool volatile 	lock_ready;
+	// lock queue entries preallocated for the rows this txn locks.
+	LockEntry * 	lock_entries;
+	LockEntry * 	free_lock_entries;
+	// the entry the txn spins on after Row_lock::lock_get() returns WAIT.
+	LockEntry * 	wait_entry;
 	bool volatile 	lock_abort; // forces another waiting txn to abort.
+#if BAMBOO
+	// [BAMBOO] # of rows on which this txn waits for retired txns to commit.
+	int volatile 	commit_semaphore;
+	// set when a retired txn this txn depends on aborts (cascading abort).
+	bool volatile 	bb_abort;
+#endif
 	// [TIMESTAMP, MVCC]
 	bool volatile 	ts_ready;
 	// [HSTORE]
 	int volatile 	ready_part;
 	RC 				finish(RC rc);
 	void 			cleanup(RC rc);
+	// [BAMBOO] called after the last write to row (returned by get_row()).
+	// No-op for the other algorithms.
+	void 			retire_row(row_t * row);
 #if CC_ALG == TICTOC
 	ts_t 			get_max_wts() 	{ return _max_wts; }
 	void 			update_max_wts(ts_t max_wts);
@@ -87,6 +105,11 @@ public:
   MICATransaction* mica_tx;
 	// bool			readonly;
 #endif
+#if (CC_ALG == TICTOC || CC_ALG == SILO) && MOCC
+	// [MOCC]
+	bool 			last_locked;
+	int 			mocc_lock_cnt;
+#endif
 
 	// For OCC
 	uint64_t 		start_ts;
@@ -131,6 +154,18 @@ public:
   row_t* search(IndexT* index, size_t key, int part_id, access_t type, const access_t* cf_access_type = NULL);
 #endif
 
+	// [table_scan] forget the read added by the last get_row(RD) call.
+	// prev_row_cnt is row_cnt before that call. 2PL releases the lock.
+	void drop_last_read(int prev_row_cnt);
+
+#if COLD_STORE
+	// [COLD_STORE] frozen rows are never written and are read without CC
+	// into a per-txn copy.
+	row_t * 		get_cold_row(row_t * ref, access_t type);
+	row_t ** 		cold_rows;
+	int 			cold_cnt;
+#endif
+
 	// insert_row/remove_row
   bool insert_row(table_t* tbl, row_t*& row, int part_id, uint64_t& row_id);
 	bool remove_row(row_t* row);
@@ -37,21 +37,29 @@ RC workload::init() {
   return RCOK;
 }
 
-RC workload::init_schema(string schema_file) {
 #if CC_ALG == MICA
-  // mica_db->activate(static_cast<uint64_t>(::mica::util::lcore.lcore_id()));
+void workload::set_mica_active(bool active) {
   std::vector<std::thread> threads;
   for (uint64_t thread_id = 0; thread_id < g_thread_cnt; thread_id++) {
     threads.emplace_back([&, thread_id] {
       ::mica::util::lcore.pin_thread(thread_id);
       mem_allocator.register_thread(thread_id);
-      mica_db->activate(thread_id);
+      if (active)
+        mica_db->activate(thread_id);
+      else
+        mica_db->deactivate(thread_id);
     });
   }
   while (threads.size() > 0) {
     threads.back().join();
     threads.pop_back();
   }
+}
+#endif
+
+RC workload::init_schema(string schema_file) {
+#if CC_ALG == MICA
+  set_mica_active(true);
 #endif
 
   assert(sizeof(uint64_t) == 8);
@@ -98,7 +106,7 @@ RC workload::init_schema(string schema_file) {
               name = token;
               break;
             case 3:
-#if TPCC_CF
+#if TPCC_CF || COLUMN_GROUP
               cf = atoi(token.c_str());
 #endif
               break;
@@ -114,6 +122,7 @@ RC workload::init_schema(string schema_file) {
         schema->add_col((char*)name.c_str(), size, (char*)type.c_str(), cf);
         col_count++;
       }
+      schema->finalize();
 
       int part_cnt = (CENTRAL_INDEX) ? 1 : g_part_cnt;
 #if WORKLOAD == TPCC
@@ -124,14 +133,7 @@ RC workload::init_schema(string schema_file) {
       assert(schema->get_tuple_size() == MAX_TUPLE_SIZE);
 #endif
 
-      table_t* cur_tab = (table_t*)mem_allocator.alloc(sizeof(table_t), -1);
-      new (cur_tab) table_t;
-#if CC_ALG == MICA
-      cur_tab->mica_db = mica_db;
-#endif
-      cur_tab->init(schema, part_cnt);
-      assert(schema->get_tuple_size() <= MAX_TUPLE_SIZE);
-      tables[tname] = cur_tab;
+      add_table(tname, schema, part_cnt);
     } else if (!line.compare(0, 6, "INDEX=")) {
       string iname;
       iname = &line[6];
@@ -165,55 +167,65 @@ RC workload::init_schema(string schema_file) {
         table_size = stoi(items[1]) * g_num_wh;
 #elif WORKLOAD == TATP
       table_size = stoi(items[1]) * TATP_SCALE_FACTOR;
+#elif WORKLOAD == SMALLBANK
+      table_size = g_sb_num_accounts;
+#else
+      table_size = stoi(items[1]);
+#endif
+
+      add_index(iname, tables[tname], part_cnt, table_size);
+    }
+  }
+  fin.close();
+
+#if CC_ALG == MICA
+  set_mica_active(false);
+#endif
+  return RCOK;
+}
+
+table_t* workload::add_table(string tname, Catalog* schema, int part_cnt) {
+  table_t* cur_tab = (table_t*)mem_allocator.alloc(sizeof(table_t), -1);
+  new (cur_tab) table_t;
+#if CC_ALG == MICA
+  cur_tab->mica_db = mica_db;
 #endif
+  cur_tab->init(schema, part_cnt);
+  assert(schema->get_tuple_size() <= MAX_TUPLE_SIZE);
+  tables[tname] = cur_tab;
+  return cur_tab;
+}
 
-      if (strncmp(iname.c_str(), "ORDERED_", 8) == 0) {
-        ORDERED_INDEX* index =
-            (ORDERED_INDEX*)mem_allocator.alloc(sizeof(ORDERED_INDEX), -1);
-        new (index) ORDERED_INDEX();
+void workload::add_index(string iname, table_t* table, int part_cnt,
+                         uint64_t table_size) {
+  if (strncmp(iname.c_str(), "ORDERED_", 8) == 0) {
+    ORDERED_INDEX* index =
+        (ORDERED_INDEX*)mem_allocator.alloc(sizeof(ORDERED_INDEX), -1);
+    new (index) ORDERED_INDEX();
 
-        index->init(part_cnt, tables[tname]);
-        ordered_indexes[iname] = index;
-      } else if (strncmp(iname.c_str(), "ARRAY_", 6) == 0) {
-        ARRAY_INDEX* index = (ARRAY_INDEX*)mem_allocator.alloc(sizeof(ARRAY_INDEX), -1);
-        new (index) ARRAY_INDEX();
+    index->init(part_cnt, table);
+    ordered_indexes[iname] = index;
+  } else if (strncmp(iname.c_str(), "ARRAY_", 6) == 0) {
+    ARRAY_INDEX* index = (ARRAY_INDEX*)mem_allocator.alloc(sizeof(ARRAY_INDEX), -1);
+    new (index) ARRAY_INDEX();
 
-        index->init(part_cnt, tables[tname], table_size * 2);
-        array_indexes[iname] = index;
-      } else if (strncmp(iname.c_str(), "HASH_", 5) == 0) {
-        HASH_INDEX* index = (HASH_INDEX*)mem_allocator.alloc(sizeof(HASH_INDEX), -1);
-        new (index) HASH_INDEX();
+    index->init(part_cnt, table, table_size * 2);
+    array_indexes[iname] = index;
+  } else if (strncmp(iname.c_str(), "HASH_", 5) == 0) {
+    HASH_INDEX* index = (HASH_INDEX*)mem_allocator.alloc(sizeof(HASH_INDEX), -1);
+    new (index) HASH_INDEX();
 
 #if INDEX_STRUCT == IDX_HASH || INDEX_STRUCT == IDX_MICA
-        index->init(part_cnt, tables[tname], table_size * 2);
+    index->init(part_cnt, table, table_size * 2);
 #else
-        index->init(part_cnt, tables[tname]);
+    index->init(part_cnt, table);
 #endif
-        hash_indexes[iname] = index;
-      }
-      else {
-        printf("unrecognized index type for %s\n", iname.c_str());
-        assert(false);
-      }
-    }
-  }
-  fin.close();
-
-#if CC_ALG == MICA
-  // mica_db->deactivate(static_cast<uint64_t>(::mica::util::lcore.lcore_id()));
-  for (uint64_t thread_id = 0; thread_id < g_thread_cnt; thread_id++) {
-    threads.emplace_back([&, thread_id] {
-      ::mica::util::lcore.pin_thread(thread_id);
-      mem_allocator.register_thread(thread_id);
-      mica_db->deactivate(thread_id);
-    });
+    hash_indexes[iname] = index;
   }
-  while (threads.size() > 0) {
-    threads.back().join();
-    threads.pop_back();
+  else {
+    printf("unrecognized index type for %s\n", iname.c_str());
+    assert(false);
   }
-#endif
-  return RCOK;
 }
 
 template <class IndexT>
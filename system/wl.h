@@ -49,4 +49,12 @@ public:
 protected:
 	template <class IndexT>
 	void index_insert(IndexT* index, uint64_t key, row_t* row, int part_id);
+	// create a table or an index as init_schema() does for the schema file.
+	// The index type comes from the prefix of iname (HASH_, ORDERED_, ARRAY_).
+	table_t * add_table(string tname, Catalog * schema, int part_cnt);
+	void add_index(string iname, table_t * table, int part_cnt, uint64_t table_size);
+#if CC_ALG == MICA
+	// the MICA tables are created with all the threads active.
+	void set_mica_active(bool active);
+#endif
 };
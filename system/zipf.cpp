@@ -0,0 +1,65 @@
+#include <algorithm>
+#include "zipf.h"
+
+void
+ZipfGen::init(uint64_t n, double theta)
+{
+	assert(n > 0);
+	_n = n;
+	_theta = theta;
+	_head_cnt = (n < HEAD_CNT)? n : HEAD_CNT;
+	double head_sum = 0;
+	for (uint32_t i = 0; i < _head_cnt; i++) {
+		head_sum += pow(1.0 / (i + 1), theta);
+		_head_cdf[i] = head_sum;
+	}
+	// the 1-based rank r covers [r - 0.5, r + 0.5) of the continuous density,
+	// so the tail mass approximates the rest of zeta(n, theta).
+	double tail_begin = _head_cnt + 0.5;
+	double tail_mass = integral(tail_begin, n + 0.5);
+	double total = head_sum + tail_mass;
+	for (uint32_t i = 0; i < _head_cnt; i++)
+		_head_cdf[i] /= total;
+	_head_mass = head_sum / total;
+	_tail_scale = (_head_cnt < n)? TAIL_STEPS / (1 - _head_mass) : 0;
+	for (uint32_t k = 0; k <= TAIL_STEPS; k++)
+		_tail[k] = inv_integral(tail_begin, tail_mass * k / TAIL_STEPS);
+}
+
+double
+ZipfGen::integral(double a, double b) const
+{
+	if (fabs(_theta - 1) < 1e-9)
+		return log(b / a);
+	return (pow(b, 1 - _theta) - pow(a, 1 - _theta)) / (1 - _theta);
+}
+
+double
+ZipfGen::inv_integral(double a, double area) const
+{
+	if (fabs(_theta - 1) < 1e-9)
+		return a * exp(area);
+	return pow(pow(a, 1 - _theta) + area * (1 - _theta), 1 / (1 - _theta));
+}
+
+uint64_t
+ZipfGen::sample(double u) const
+{
+	if (u < _head_mass || _head_cnt == _n) {
+		uint64_t rank = std::upper_bound(_head_cdf, _head_cdf + _head_cnt, u)
+			- _head_cdf;
+		return (rank < _head_cnt)? rank : _head_cnt - 1;
+	}
+	double pos = (u - _head_mass) * _tail_scale;
+	uint32_t k = (uint32_t) pos;
+	if (k >= TAIL_STEPS)
+		k = TAIL_STEPS - 1;
+	double x = _tail[k] + (pos - k) * (_tail[k + 1] - _tail[k]);
+	// back to a 0-based rank.
+	uint64_t rank = (uint64_t) (x - 0.5);
+	if (rank < _head_cnt)
+		rank = _head_cnt;
+	if (rank >= _n)
+		rank = _n - 1;
+	return rank;
+}
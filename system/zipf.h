@@ -0,0 +1,33 @@
+#pragma once
+
+#include "global.h"
+
+// Samples ranks in [0, n) with P(rank) proportional to 1 / (rank + 1)^theta.
+// The first HEAD_CNT ranks are drawn from their exact CDF. The other ranks
+// are drawn by interpolating a table of quantiles of the continuous x^-theta
+// density, which is within a fraction of a percent of the discrete one
+// there. init() is O(HEAD_CNT + TAIL_STEPS) for any n, and sample() makes
+// no pow() calls.
+class ZipfGen {
+public:
+	void 		init(uint64_t n, double theta);
+	// u is uniform in [0, 1).
+	uint64_t 	sample(double u) const;
+	uint64_t 	get_n() const { return _n; }
+	double 		get_theta() const { return _theta; }
+private:
+	static const uint32_t HEAD_CNT = 256;
+	static const uint32_t TAIL_STEPS = 4096;
+	// integral of x^-theta over [a, b], and the b that gives area.
+	double 		integral(double a, double b) const;
+	double 		inv_integral(double a, double area) const;
+
+	uint64_t 	_n;
+	double 		_theta;
+	uint32_t 	_head_cnt;
+	double 		_head_mass;
+	double 		_tail_scale;
+	double 		_head_cdf[HEAD_CNT];
+	// _tail[k] is the k / TAIL_STEPS quantile of the tail, in 1-based ranks.
+	double 		_tail[TAIL_STEPS + 1];
+};